@@ -0,0 +1,251 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// BloomFilter.hpp - Header file for the blocked_bloom_filter class.
+/// \file BloomFilter.hpp
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <bit>
+#include <HashMath.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// a split block bloom filter: every key sets one bit in each of the eight 32 bit words of a single 32 byte block, so a
+// query reads one block, a cache line at most, and rejects a key that was never inserted unless all eight bits happen to
+// be set. sized at 8 bits per key, which puts false positives at about 3% once the filter is full. there is no erase, a
+// removed key's bits stay set until the filter gets rebuilt.
+class blocked_bloom_filter {
+  public:
+	static constexpr size_t keys_per_block = 32;
+
+	blocked_bloom_filter() noexcept = default;
+	blocked_bloom_filter(const blocked_bloom_filter& other) {
+		*this = other;
+	}
+	blocked_bloom_filter(blocked_bloom_filter&& other) noexcept {
+		swap(other);
+	}
+	blocked_bloom_filter& operator=(const blocked_bloom_filter& other) {
+		if (this != &other) {
+			if (block_count != other.block_count) {
+				release();
+				allocate(other.block_count);
+			}
+			if (block_count) {
+				std::memcpy(blocks, other.blocks, sizeof(block) * block_count);
+			}
+		}
+		return *this;
+	}
+	blocked_bloom_filter& operator=(blocked_bloom_filter&& other) noexcept {
+		swap(other);
+		return *this;
+	}
+	~blocked_bloom_filter() {
+		release();
+	}
+
+	// makes room for max_keys keys and forgets everything inserted so far
+	void reset(size_t max_keys) {
+		size_t count = std::bit_ceil(std::max<size_t>(1, (max_keys + keys_per_block - 1) / keys_per_block));
+		if (count != block_count) {
+			release();
+			allocate(count);
+		}
+		clear();
+	}
+	void clear() {
+		if (block_count) {
+			std::memset(blocks, 0, sizeof(block) * block_count);
+		}
+	}
+	void release() {
+		if (block_count) {
+			std::allocator<block>().deallocate(blocks, block_count);
+		}
+		blocks = empty_block();
+		block_count = 0;
+		block_mask = 0;
+	}
+	void swap(blocked_bloom_filter& other) noexcept {
+		std::swap(blocks, other.blocks);
+		std::swap(block_count, other.block_count);
+		std::swap(block_mask, other.block_mask);
+	}
+
+	// only after reset(). a filter that was never sized has no block to set bits in
+	void insert(uint64_t hash) {
+		hash = detailv3::mix_hash(hash);
+		block& target = blocks[(hash >> 32) & block_mask];
+#if defined(__AVX2__)
+		__m256i* words = reinterpret_cast<__m256i*>(target.words);
+		_mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words), bit_mask(static_cast<uint32_t>(hash))));
+#else
+		for (size_t x = 0; x < 8; ++x) {
+			target.words[x] |= bit_for(static_cast<uint32_t>(hash), x);
+		}
+#endif
+	}
+	// false means the key was never inserted. an empty filter says false to everything
+	bool may_contain(uint64_t hash) const {
+		hash = detailv3::mix_hash(hash);
+		const block& target = blocks[(hash >> 32) & block_mask];
+#if defined(__AVX2__)
+		return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(target.words)), bit_mask(static_cast<uint32_t>(hash)));
+#else
+		bool result = true;
+		for (size_t x = 0; x < 8; ++x) {
+			result &= (target.words[x] & bit_for(static_cast<uint32_t>(hash), x)) != 0;
+		}
+		return result;
+#endif
+	}
+
+	size_t memory_usage() const {
+		return block_count * sizeof(block);
+	}
+
+  private:
+	struct alignas(32) block {
+		uint32_t words[8];
+	};
+	static constexpr uint32_t salts[8] = { 0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+
+	block* blocks = empty_block();
+	size_t block_count = 0;
+	size_t block_mask = 0;
+
+	static block* empty_block() {
+		alignas(32) static block result{};
+		return &result;
+	}
+	void allocate(size_t count) {
+		blocks = std::allocator<block>().allocate(count);
+		block_count = count;
+		block_mask = count - 1;
+	}
+	static uint32_t bit_for(uint32_t key, size_t word) {
+		return uint32_t(1) << ((key * salts[word]) >> 27);
+	}
+#if defined(__AVX2__)
+	static __m256i bit_mask(uint32_t key) {
+		const __m256i salt = _mm256_setr_epi32(static_cast<int32_t>(salts[0]), static_cast<int32_t>(salts[1]), static_cast<int32_t>(salts[2]),
+			static_cast<int32_t>(salts[3]), static_cast<int32_t>(salts[4]), static_cast<int32_t>(salts[5]), static_cast<int32_t>(salts[6]),
+			static_cast<int32_t>(salts[7]));
+		__m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int32_t>(key)), salt), 27);
+		return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+	}
+#endif
+};
+
+namespace detailv3 {
+	// what a table that may or may not keep a filter inherits. without one, every key may be present
+	template<bool UseFilter> struct lookup_filter {
+		static constexpr bool uses_filter = false;
+		bool filter_may_contain(uint64_t) const {
+			return true;
+		}
+		void filter_insert(uint64_t) {
+		}
+		bool filter_needs_refill() const {
+			return false;
+		}
+		void filter_refill_start() {
+		}
+		void filter_refill_insert(uint64_t) {
+		}
+		void filter_reset(size_t) {
+		}
+		void filter_clear() {
+		}
+		void filter_release() {
+		}
+		void filter_swap(lookup_filter&) {
+		}
+		size_t filter_memory_usage() const {
+			return 0;
+		}
+	};
+	template<> struct lookup_filter<true> {
+		static constexpr bool uses_filter = true;
+		bool filter_may_contain(uint64_t hash) const {
+			return filter.may_contain(hash);
+		}
+		void filter_insert(uint64_t hash) {
+			filter.insert(hash);
+			++inserts;
+		}
+		// the filter was sized for max_keys keys at the last reset. erased keys keep their bits, so a table whose size
+		// holds steady while keys churn through it goes on adding bits until every query says maybe. once more keys have
+		// gone in than it was sized for, the table should start over with filter_refill_start() and hand back the keys it
+		// still holds through filter_refill_insert(), which don't count, so a table that's nearly full refills once per
+		// max_keys inserts rather than on every one
+		bool filter_needs_refill() const {
+			return inserts > max_keys;
+		}
+		void filter_refill_start() {
+			filter.clear();
+			inserts = 0;
+		}
+		void filter_refill_insert(uint64_t hash) {
+			filter.insert(hash);
+		}
+		void filter_reset(size_t max_keys_new) {
+			filter.reset(max_keys_new);
+			max_keys = max_keys_new;
+			inserts = 0;
+		}
+		void filter_clear() {
+			filter.clear();
+			inserts = 0;
+		}
+		void filter_release() {
+			filter.release();
+			max_keys = 0;
+			inserts = 0;
+		}
+		void filter_swap(lookup_filter& other) {
+			filter.swap(other.filter);
+			std::swap(max_keys, other.max_keys);
+			std::swap(inserts, other.inserts);
+		}
+		size_t filter_memory_usage() const {
+			return filter.memory_usage();
+		}
+
+		blocked_bloom_filter filter;
+		size_t max_keys = 0;
+		size_t inserts = 0;
+	};
+}
@@ -0,0 +1,550 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// ClockCache.hpp - Header file for the clock_cache class.
+/// \file ClockCache.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <string>
+#include <vector>
+
+namespace detailv3 {
+	// a robin hood slot laid out like sherwood_v3_entry, with CLOCK's reference bit in the byte after distance_from_desired.
+	// for any value aligned wider than a byte that byte is padding in sherwood_v3_entry anyway, so the bit costs nothing.
+	// every entry weighs 1 unless the cache has a weigher, in which case the slot remembers what it was charged
+	template<typename T, bool Weighed = false> struct clock_cache_entry {
+		clock_cache_entry() {
+		}
+		~clock_cache_entry() {
+		}
+
+		bool has_value() const {
+			return distance_from_desired >= 0;
+		}
+		bool is_empty() const {
+			return distance_from_desired < 0;
+		}
+		bool is_at_desired_position() const {
+			return distance_from_desired <= 0;
+		}
+		size_t weight() const {
+			return 1;
+		}
+		void set_weight(size_t) {
+		}
+
+		int8_t distance_from_desired = -1;
+		uint8_t referenced = 0;
+		union {
+			T value;
+		};
+	};
+	template<typename T> struct clock_cache_entry<T, true> : clock_cache_entry<T, false> {
+		size_t weight() const {
+			return stored_weight;
+		}
+		void set_weight(size_t weight) {
+			stored_weight = weight;
+		}
+
+		size_t stored_weight = 0;
+	};
+
+	// bytes a value keeps on the heap past its own sizeof. strings count their buffer once it's outgrown the small
+	// one, vectors their capacity plus whatever their elements own, and anything else nothing
+	template<typename C, typename T, typename A> size_t heap_bytes(const std::basic_string<C, T, A>& value);
+	template<typename T, typename A> size_t heap_bytes(const std::vector<T, A>& value);
+	template<typename F, typename S> size_t heap_bytes(const std::pair<F, S>& value);
+
+	template<typename T> size_t heap_bytes(const T&) {
+		return 0;
+	}
+	template<typename C, typename T, typename A> size_t heap_bytes(const std::basic_string<C, T, A>& value) {
+		return value.capacity() > std::basic_string<C, T, A>{}.capacity() ? (value.capacity() + 1) * sizeof(C) : 0;
+	}
+	template<typename T, typename A> size_t heap_bytes(const std::vector<T, A>& value) {
+		size_t result = value.capacity() * sizeof(T);
+		if constexpr (!std::is_arithmetic_v<T> && !std::is_pointer_v<T>) {
+			for (auto& element: value) {
+				result += heap_bytes(element);
+			}
+		}
+		return result;
+	}
+	template<typename F, typename S> size_t heap_bytes(const std::pair<F, S>& value) {
+		return heap_bytes(value.first) + heap_bytes(value.second);
+	}
+}
+
+// charges every entry 1, so a clock_cache's capacity is a number of entries
+struct count_weigher {
+	template<typename K, typename V> size_t operator()(const K&, const V&) const {
+		return 1;
+	}
+};
+
+// charges every entry its approximate byte footprint: the slot it sits in plus whatever its key and value own on the
+// heap, so a clock_cache's capacity is a number of bytes. the empty slots kept for the load factor aren't charged to
+// anyone, so the slot array can come to about twice its entries' share of the budget
+template<typename K, typename V> struct footprint_weigher {
+	size_t operator()(const K& key, const V& value) const {
+		return sizeof(detailv3::clock_cache_entry<std::pair<K, V>, true>) + detailv3::heap_bytes(key) + detailv3::heap_bytes(value);
+	}
+};
+
+// a cache that holds at most capacity() entries, in a robin hood table laid out like flat_hash_map's, and evicts with
+// CLOCK: get() and put() set an entry's reference bit, and when an insert goes over capacity the hand sweeps the slot
+// array, clearing the bits it passes, and evicts the first entry whose bit is already clear. so every lookup is a single
+// probe with no list to splice, and the price is an approximation of LRU that can keep a cold entry for one more sweep.
+// new entries start with the bit clear, so a key that's put once and never read again is the first to go rather than
+// pushing out everything older than it the way it would under LRU.
+//
+// capacity() is a budget in whatever units the weigher W charges for an entry. with count_weigher that's entries, the
+// table is sized up front so it stays at most max_load_factor full at capacity, and only grows if a probe ever runs past
+// max_lookups. with any other weigher each slot remembers its entry's weight, the table grows with max_load_factor like
+// flat_hash_map's, and a put() evicts for as long as it takes to get the total back under budget, so one big value can
+// push out many small ones. see budgeted_clock_cache for a cache with a byte budget.
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>,
+	typename W = count_weigher>
+class clock_cache : private H, private E, private W {
+	static constexpr bool weighed = !std::is_same_v<W, count_weigher>;
+	using Entry = detailv3::clock_cache_entry<std::pair<K, V>, weighed>;
+	using EntryAlloc = typename std::allocator_traits<A>::template rebind_alloc<Entry>;
+	using EntryTraits = std::allocator_traits<EntryAlloc>;
+	static constexpr float max_load_factor = 0.8f;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+	using weigher = W;
+
+	explicit clock_cache(size_type capacity, const H& hash = H(), const E& equal = E(), const A& alloc = A(), const W& weigh = W())
+		: H(hash), E(equal), W(weigh), entry_alloc(alloc), max_size(std::max(capacity, size_type(1))) {
+		allocate_initial_entries();
+	}
+	clock_cache(const clock_cache& other)
+		: H(other), E(other), W(other), entry_alloc(EntryTraits::select_on_container_copy_construction(other.entry_alloc)), max_size(other.max_size) {
+		copy_entries(other);
+	}
+	// the cache moved from keeps its capacity and no slots, and allocates them again on its next put()
+	clock_cache(clock_cache&& other) noexcept
+		: H(std::move(other)), E(std::move(other)), W(std::move(other)), entry_alloc(std::move(other.entry_alloc)), max_size(other.max_size) {
+		swap_pointers(other);
+	}
+	// the slots only ever go back to the allocator that made them, so an allocator that doesn't propagate and doesn't
+	// compare equal gets the entries copied or moved over one at a time, as in cuckoo_hash_map
+	clock_cache& operator=(const clock_cache& other) {
+		if (this == std::addressof(other))
+			return *this;
+		clear();
+		deallocate_entries();
+		if constexpr (EntryTraits::propagate_on_container_copy_assignment::value) {
+			entry_alloc = other.entry_alloc;
+		}
+		static_cast<H&>(*this) = other;
+		static_cast<E&>(*this) = other;
+		static_cast<W&>(*this) = other;
+		max_size = other.max_size;
+		copy_entries(other);
+		return *this;
+	}
+	clock_cache& operator=(clock_cache&& other) noexcept(
+		EntryTraits::propagate_on_container_move_assignment::value || EntryTraits::is_always_equal::value) {
+		if (this == std::addressof(other))
+			return *this;
+		if constexpr (EntryTraits::propagate_on_container_move_assignment::value) {
+			clear();
+			deallocate_entries();
+			entry_alloc = std::move(other.entry_alloc);
+			swap_pointers(other);
+		} else if (entry_alloc == other.entry_alloc) {
+			swap_pointers(other);
+		} else {
+			clear();
+			deallocate_entries();
+			max_size = other.max_size;
+			if (other.entries) {
+				allocate_entries(other.num_slots);
+				for (Entry *it = other.entries, *end = other.entries + other.num_entries() - 1; it != end; ++it) {
+					if (it->has_value()) {
+						place_new(std::move(it->value), it->referenced, it->weight());
+					}
+				}
+				total_weight = other.total_weight;
+				other.clear();
+			}
+		}
+		static_cast<H&>(*this) = std::move(static_cast<H&>(other));
+		static_cast<E&>(*this) = std::move(static_cast<E&>(other));
+		static_cast<W&>(*this) = std::move(static_cast<W&>(other));
+		return *this;
+	}
+	~clock_cache() {
+		clear();
+		deallocate_entries();
+	}
+
+	// the value for key, now marked as recently used, or nullptr. the pointer is good until the next put(). a weighed
+	// entry stays charged what it weighed when it was put, however its value changes through the pointer
+	V* get(const K& key) {
+		if (Entry* found = find_entry(key)) {
+			found->referenced = 1;
+			return std::addressof(found->value.second);
+		}
+		return nullptr;
+	}
+	// like get(), but leaves the reference bit alone
+	bool contains(const K& key) const {
+		return const_cast<clock_cache*>(this)->find_entry(key) != nullptr;
+	}
+
+	// sets key's value. an existing key gets marked as recently used. a new key that takes the cache over capacity()
+	// costs the entries the CLOCK hand stops at, never the key just put. an entry that weighs more than capacity() on its
+	// own isn't kept, and takes any older value for its key with it. true when the key is new and was kept
+	template<typename Key, typename... Args> bool put(Key&& key, Args&&... args) {
+		if (!entries) {
+			allocate_initial_entries();
+		}
+		Entry* current = entries + index_for_hash(hash_object(key));
+		int8_t distance = 0;
+		for (; current->distance_from_desired >= distance; ++current, ++distance) {
+			if (compares_equal(key, current->value.first)) {
+				current->value.second = V(std::forward<Args>(args)...);
+				current->referenced = 1;
+				if constexpr (weighed) {
+					size_t weight = weigh(current->value);
+					total_weight = total_weight - current->weight() + weight;
+					current->set_weight(weight);
+					if (weight > max_size) {
+						erase_entry(current);
+					} else {
+						evict_to_budget(current);
+					}
+				}
+				return false;
+			}
+		}
+		if constexpr (weighed) {
+			value_type value(std::forward<Key>(key), V(std::forward<Args>(args)...));
+			size_t weight = weigh(value);
+			if (weight > max_size) {
+				return false;
+			}
+			if (num_elements + 1 > num_slots * max_load_factor) {
+				grow();
+				current = entries + index_for_hash(hash_object(value.first));
+				distance = 0;
+			}
+			total_weight += weight;
+			evict_to_budget(emplace_at(current, distance, std::move(value), 0, weight));
+		} else {
+			Entry* inserted = emplace_at(current, distance, value_type(std::forward<Key>(key), V(std::forward<Args>(args)...)), 0, 1);
+			++total_weight;
+			if (total_weight > max_size) {
+				evict_one(inserted);
+			}
+		}
+		return true;
+	}
+
+	size_t erase(const K& key) {
+		if (Entry* found = find_entry(key)) {
+			erase_entry(found);
+			return 1;
+		}
+		return 0;
+	}
+
+	void clear() {
+		if (!entries) {
+			return;
+		}
+		for (Entry *it = entries, *end = entries + num_entries() - 1; it != end; ++it) {
+			if (it->has_value()) {
+				destroy_entry(it);
+			}
+		}
+		num_elements = 0;
+		total_weight = 0;
+		hand = 0;
+	}
+
+	void swap(clock_cache& other) {
+		using std::swap;
+		swap(static_cast<H&>(*this), static_cast<H&>(other));
+		swap(static_cast<E&>(*this), static_cast<E&>(other));
+		swap(static_cast<W&>(*this), static_cast<W&>(other));
+		swap_pointers(other);
+		if constexpr (EntryTraits::propagate_on_container_swap::value) {
+			swap(entry_alloc, other.entry_alloc);
+		}
+	}
+
+	size_t size() const {
+		return num_elements;
+	}
+	bool empty() const {
+		return num_elements == 0;
+	}
+	// the budget, in the weigher's units
+	size_t capacity() const {
+		return max_size;
+	}
+	// what the entries held weigh between them, never more than capacity() between calls
+	size_t weight() const {
+		return total_weight;
+	}
+	size_t bucket_count() const {
+		return num_slots;
+	}
+	// bytes held by the slot array, the max_lookups slots past the last bucket included
+	size_t memory_usage() const {
+		return entries ? num_entries() * sizeof(Entry) : 0;
+	}
+
+  private:
+	EntryAlloc entry_alloc;
+	Entry* entries = nullptr;
+	size_t num_slots = 0;
+	int8_t shift = 63;
+	int8_t max_lookups = detailv3::min_lookups - 1;
+	size_t num_elements = 0;
+	size_t max_size = 0;
+	size_t total_weight = 0;
+	// the slot the CLOCK hand points at
+	size_t hand = 0;
+
+	// the slots, the max_lookups - 1 that a probe from the last one can run into, and the end marker after them
+	size_t num_entries() const {
+		return num_slots + max_lookups;
+	}
+
+	void swap_pointers(clock_cache& other) {
+		using std::swap;
+		swap(entries, other.entries);
+		swap(num_slots, other.num_slots);
+		swap(shift, other.shift);
+		swap(max_lookups, other.max_lookups);
+		swap(num_elements, other.num_elements);
+		swap(max_size, other.max_size);
+		swap(total_weight, other.total_weight);
+		swap(hand, other.hand);
+	}
+
+	void allocate_entries(size_t count) {
+		num_slots = count;
+		shift = static_cast<int8_t>(64 - std::countr_zero(count));
+		max_lookups = std::max(detailv3::min_lookups, detailv3::log2(count));
+		entries = EntryTraits::allocate(entry_alloc, num_entries());
+		for (Entry *it = entries, *end = entries + num_entries() - 1; it != end; ++it) {
+			it->distance_from_desired = -1;
+		}
+		// reads as a value at its desired position, so probes and backward shifts both stop there
+		entries[num_entries() - 1].distance_from_desired = 0;
+	}
+	void allocate_initial_entries() {
+		if constexpr (weighed) {
+			allocate_entries(size_t(1) << detailv3::min_lookups);
+		} else {
+			allocate_entries(std::bit_ceil(static_cast<size_t>(std::ceil(max_size / static_cast<double>(max_load_factor)))));
+		}
+	}
+	void deallocate_entries() {
+		if (entries) {
+			EntryTraits::deallocate(entry_alloc, entries, num_entries());
+			entries = nullptr;
+			num_slots = 0;
+			shift = 63;
+			max_lookups = detailv3::min_lookups - 1;
+		}
+	}
+	void copy_entries(const clock_cache& other) {
+		if (!other.entries) {
+			return;
+		}
+		allocate_entries(other.num_slots);
+		for (Entry *it = other.entries, *end = other.entries + other.num_entries() - 1; it != end; ++it) {
+			if (it->has_value()) {
+				value_type copy(it->value);
+				place_new(std::move(copy), it->referenced, it->weight());
+			}
+		}
+		total_weight = other.total_weight;
+	}
+
+	// for count_weigher only reached when a probe would have run past max_lookups, which at max_load_factor takes a badly
+	// clustered hash. a weighed cache also grows here when an insert would take it past max_load_factor
+	void grow() {
+		Entry* old_entries = entries;
+		Entry* old_end = entries + num_entries() - 1;
+		size_t old_count = num_entries();
+		allocate_entries(num_slots * 2);
+		num_elements = 0;
+		hand = 0;
+		for (Entry* it = old_entries; it != old_end; ++it) {
+			if (it->has_value()) {
+				place_new(std::move(it->value), it->referenced, it->weight());
+				it->value.~value_type();
+			}
+		}
+		EntryTraits::deallocate(entry_alloc, old_entries, old_count);
+	}
+
+	Entry* find_entry(const K& key) {
+		if (!entries) {
+			return nullptr;
+		}
+		Entry* current = entries + index_for_hash(hash_object(key));
+		for (int8_t distance = 0; current->distance_from_desired >= distance; ++current, ++distance) {
+			if (compares_equal(key, current->value.first))
+				return current;
+		}
+		return nullptr;
+	}
+
+	Entry* place_new(value_type&& value, uint8_t referenced, size_t weight) {
+		return emplace_at(entries + index_for_hash(hash_object(value.first)), 0, std::move(value), referenced, weight);
+	}
+	// robin hood insertion of a key that isn't in the table, from the slot where the lookup for it gave up: whatever sits
+	// closer to its own desired slot than the element in hand gets swapped out and carried on down. returns the slot the
+	// new element ended up in. a displacement that would carry some element past max_lookups grows the table before
+	// anything has moved, so the new element is never in the table when it's rebuilt
+	Entry* emplace_at(Entry* current, int8_t distance, value_type&& value, uint8_t referenced, size_t weight) {
+		if (!fits_without_growing(current, distance)) {
+			grow();
+			return place_new(std::move(value), referenced, weight);
+		}
+		Entry* result = nullptr;
+		for (;; ++current, ++distance) {
+			if (current->is_empty()) {
+				::new (static_cast<void*>(std::addressof(current->value))) value_type(std::move(value));
+				current->distance_from_desired = distance;
+				current->referenced = referenced;
+				current->set_weight(weight);
+				++num_elements;
+				return result ? result : current;
+			}
+			if (current->distance_from_desired < distance) {
+				if (!result) {
+					result = current;
+				}
+				using std::swap;
+				swap(value, current->value);
+				swap(distance, current->distance_from_desired);
+				swap(referenced, current->referenced);
+				size_t displaced_weight = current->weight();
+				current->set_weight(weight);
+				weight = displaced_weight;
+			}
+		}
+	}
+
+	// walks the slots emplace_at() would, tracking only the distance of the element it would be carrying
+	bool fits_without_growing(const Entry* current, int8_t distance) const {
+		for (;; ++current, ++distance) {
+			if (distance == max_lookups) {
+				return false;
+			}
+			if (current->is_empty()) {
+				return true;
+			}
+			if (current->distance_from_desired < distance) {
+				distance = current->distance_from_desired;
+			}
+		}
+	}
+
+	void destroy_entry(Entry* entry) {
+		entry->value.~value_type();
+		entry->distance_from_desired = -1;
+	}
+	// backward shift deletion, as in flat_hash_map: the run of displaced elements after the erased one each move up a slot.
+	// returns the first slot past that run, the one element that didn't move
+	Entry* erase_entry(Entry* current) {
+		total_weight -= current->weight();
+		destroy_entry(current);
+		--num_elements;
+		Entry* next = current + 1;
+		for (; !next->is_at_desired_position(); ++current, ++next) {
+			::new (static_cast<void*>(std::addressof(current->value))) value_type(std::move(next->value));
+			current->distance_from_desired = next->distance_from_desired - 1;
+			current->referenced = next->referenced;
+			current->set_weight(next->weight());
+			destroy_entry(next);
+		}
+		return next;
+	}
+
+	// sweeps the hand on from where it stopped last time, passing over keep, the entry that was just put, and returns
+	// where keep ended up after the backward shift. the hand stays on the slot it evicts from, since the shift may have
+	// moved an element it hasn't looked at yet into it
+	Entry* evict_one(Entry* keep) {
+		for (size_t end = num_entries() - 1;; ++hand) {
+			if (hand >= end) {
+				hand = 0;
+			}
+			Entry* current = entries + hand;
+			if (current->has_value() && current != keep) {
+				if (!current->referenced) {
+					Entry* unmoved = erase_entry(current);
+					return keep > current && keep < unmoved ? keep - 1 : keep;
+				}
+				current->referenced = 0;
+			}
+		}
+	}
+	// keep weighs no more than capacity() on its own, so there's always something else to evict while the total is over
+	void evict_to_budget(Entry* keep) {
+		while (total_weight > max_size) {
+			keep = evict_one(keep);
+		}
+	}
+
+	size_t weigh(const value_type& value) const {
+		return static_cast<const W&>(*this)(value.first, value.second);
+	}
+
+	size_t index_for_hash(size_t hash) const {
+		return (11400714819323198485ull * hash) >> shift;
+	}
+	template<typename U> size_t hash_object(const U& key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	template<typename L, typename R> bool compares_equal(const L& lhs, const R& rhs) const {
+		return static_cast<const E&>(*this)(lhs, rhs);
+	}
+};
+
+// a clock_cache whose capacity is a budget in bytes rather than entries, for values whose sizes vary too much for an
+// entry count to bound the memory they take
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>,
+	typename W = footprint_weigher<K, V>>
+using budgeted_clock_cache = clock_cache<K, V, H, E, A, W>;
@@ -0,0 +1,257 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// ConcurrentMap.hpp - Header file for the ConcurrentMap class.
+/// \file ConcurrentMap.hpp
+
+#pragma once
+
+#include <PersistentMap.hpp>
+#include <shared_mutex>
+#include <stdexcept>
+#include <optional>
+#include <array>
+#include <mutex>
+#include <bit>
+
+namespace DiscordCoreAPI {
+
+	// a map that many threads can read and write at once, split by the top bits of the key's hash into SegmentCount
+	// segments, each a PersistentMap behind a reader/writer lock of its own. snapshot() takes every segment's lock, in
+	// order, just long enough to copy its map, which is O(1), so it gives a point in time view of the whole map while
+	// holding up writers for a few atomic increments. a scan of the snapshot then runs with no lock at all. the writes that
+	// land in the meantime copy the trie nodes on their paths rather than changing them, so the snapshot only ever costs
+	// memory for the parts of the map written to while it's alive.
+	template<typename KeyType, typename ValueType, uint64_t SegmentCount = 16> class ConcurrentMap : protected KeyHasher {
+	  public:
+		static_assert(std::has_single_bit(SegmentCount), "SegmentCount must be a power of two.");
+
+		using mapped_type = ValueType;
+		using key_type = KeyType;
+		using value_type = Pair<key_type, mapped_type>;
+		using size_type = uint64_t;
+		using key_hasher = KeyHasher;
+		using segment_map = PersistentMap<key_type, mapped_type>;
+
+		class Snapshot;
+
+		inline ConcurrentMap() = default;
+		inline ConcurrentMap(const ConcurrentMap&) = delete;
+		inline ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+		// like UnorderedMap, emplacing a key that's already present replaces its value. true when the key is new.
+		template<typename key_type_new, typename... Args> inline bool emplace(key_type_new&& key, Args&&... value) {
+			auto& segment = segmentFor(key);
+			std::unique_lock lock{ segment.mutex };
+			return segment.map.emplace(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+		}
+
+		// true when the key was there to erase.
+		template<typename key_type_new> inline bool erase(const key_type_new& key) {
+			auto& segment = segmentFor(key);
+			std::unique_lock lock{ segment.mutex };
+			return segment.map.erase(key);
+		}
+
+		// a copy of the value, since a reference could be overwritten as soon as the lock is let go.
+		template<typename key_type_new> inline std::optional<mapped_type> get(const key_type_new& key) const {
+			auto& segment = segmentFor(key);
+			std::shared_lock lock{ segment.mutex };
+			auto iterator = segment.map.find(key);
+			if (iterator == segment.map.end()) {
+				return std::nullopt;
+			}
+			return iterator->second;
+		}
+
+		template<typename key_type_new> inline mapped_type at(const key_type_new& key) const {
+			auto& segment = segmentFor(key);
+			std::shared_lock lock{ segment.mutex };
+			return segment.map.at(key);
+		}
+
+		template<typename key_type_new> inline bool contains(const key_type_new& key) const {
+			auto& segment = segmentFor(key);
+			std::shared_lock lock{ segment.mutex };
+			return segment.map.contains(key);
+		}
+
+		// every segment at one instant: no write can land in one segment between the copies of two others, since each
+		// segment's lock is held until the last one is copied.
+		inline Snapshot snapshot() const {
+			std::array<std::shared_lock<std::shared_mutex>, SegmentCount> locks{};
+			for (uint64_t x = 0; x < SegmentCount; ++x) {
+				locks[x] = std::shared_lock{ segments[x].mutex };
+			}
+			Snapshot result{};
+			for (uint64_t x = 0; x < SegmentCount; ++x) {
+				result.maps[x] = segments[x].map.snapshot();
+			}
+			return result;
+		}
+
+		inline size_type size() const {
+			return snapshot().size();
+		}
+
+		inline bool empty() const {
+			return size() == 0;
+		}
+
+		inline void clear() {
+			for (auto& segment: segments) {
+				segment_map released{};
+				{
+					std::unique_lock lock{ segment.mutex };
+					released.swap(segment.map);
+				}
+			}
+		}
+
+		// a point in time copy of a ConcurrentMap, for long scans such as serialization. it's an ordinary read only map that
+		// belongs to the thread holding it.
+		class Snapshot {
+		  public:
+			class ConstIterator {
+			  public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = ConcurrentMap::value_type;
+				using difference_type = std::ptrdiff_t;
+				using reference = const value_type&;
+				using pointer = const value_type*;
+
+				inline ConstIterator() = default;
+
+				inline ConstIterator(const Snapshot* snapshotNew, uint64_t segmentNew, typename segment_map::const_iterator iteratorNew)
+					: snapshot{ snapshotNew }, segment{ segmentNew }, iterator{ iteratorNew } {
+					skipEmptySegments();
+				}
+
+				inline reference operator*() const {
+					return *iterator;
+				}
+
+				inline pointer operator->() const {
+					return iterator.operator->();
+				}
+
+				inline ConstIterator& operator++() {
+					++iterator;
+					skipEmptySegments();
+					return *this;
+				}
+
+				inline ConstIterator operator++(int32_t) {
+					auto copy = *this;
+					++*this;
+					return copy;
+				}
+
+				inline bool operator==(const ConstIterator& other) const {
+					return iterator == other.iterator;
+				}
+
+			  protected:
+				const Snapshot* snapshot{};
+				uint64_t segment{};
+				typename segment_map::const_iterator iterator{};
+
+				inline void skipEmptySegments() {
+					while (snapshot && iterator == snapshot->maps[segment].end() && ++segment < SegmentCount) {
+						iterator = snapshot->maps[segment].begin();
+					}
+				}
+			};
+
+			using iterator = ConstIterator;
+			using const_iterator = ConstIterator;
+
+			inline const_iterator begin() const {
+				return { this, 0, maps[0].begin() };
+			}
+
+			inline const_iterator end() const {
+				return {};
+			}
+
+			template<typename key_type_new> inline const_iterator find(const key_type_new& key) const {
+				auto segment = segmentIndexFor(key);
+				auto iterator = maps[segment].find(key);
+				return iterator == maps[segment].end() ? end() : const_iterator{ this, segment, iterator };
+			}
+
+			template<typename key_type_new> inline const mapped_type& at(const key_type_new& key) const {
+				return maps[segmentIndexFor(key)].at(key);
+			}
+
+			template<typename key_type_new> inline bool contains(const key_type_new& key) const {
+				return maps[segmentIndexFor(key)].contains(key);
+			}
+
+			inline size_type size() const {
+				size_type result{};
+				for (auto& map: maps) {
+					result += map.size();
+				}
+				return result;
+			}
+
+			inline bool empty() const {
+				return size() == 0;
+			}
+
+		  protected:
+			friend class ConcurrentMap;
+			std::array<segment_map, SegmentCount> maps{};
+		};
+
+	  protected:
+		// on cache lines of their own, so that writers in neighbouring segments don't fight over the locks.
+		struct alignas(64) Segment {
+			mutable std::shared_mutex mutex{};
+			segment_map map{};
+		};
+
+		std::array<Segment, SegmentCount> segments{};
+
+		// the top bits of the hash pick the segment, which leaves the low bits, the ones PersistentMap indexes its first
+		// levels by, spread evenly over every segment.
+		template<typename key_type_new> inline static uint64_t segmentIndexFor(const key_type_new& key) {
+			if constexpr (SegmentCount == 1) {
+				return 0;
+			} else {
+				return key_hasher()(key) >> (64 - std::countr_zero(SegmentCount));
+			}
+		}
+
+		template<typename key_type_new> inline Segment& segmentFor(const key_type_new& key) {
+			return segments[segmentIndexFor(key)];
+		}
+
+		template<typename key_type_new> inline const Segment& segmentFor(const key_type_new& key) const {
+			return segments[segmentIndexFor(key)];
+		}
+	};
+}
@@ -0,0 +1,541 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// CuckooHashMap.hpp - Header file for the cuckoo_hash_map class.
+/// \file CuckooHashMap.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <stdexcept>
+#include <optional>
+#include <tuple>
+
+namespace detailv3 {
+	// SlotsPerBucket elements plus a tag byte for each of them. the tags come first, so a probe that finds no matching tag
+	// is done with the bucket after reading its first few bytes. a tag of zero means the slot is empty
+	template<typename T, size_t SlotsPerBucket> struct cuckoo_bucket {
+		T* slot(size_t index) {
+			return std::launder(reinterpret_cast<T*>(storage[index]));
+		}
+		const T* slot(size_t index) const {
+			return std::launder(reinterpret_cast<const T*>(storage[index]));
+		}
+
+		uint8_t tags[SlotsPerBucket];
+		alignas(T) unsigned char storage[SlotsPerBucket][sizeof(T)];
+	};
+}
+
+// bucketized cuckoo hashing: every key has two candidate buckets of SlotsPerBucket slots each, and lives in one of
+// them, so a lookup reads at most two buckets no matter how full the table is. an insert that finds both buckets full
+// searches breadth first for a short chain of elements that can each move to their other bucket, and only grows the
+// table when no such chain exists. that lets it run at a max_load_factor of 0.95 where the robin hood tables stop at 0.5.
+// the second bucket is worked out from the first and the key's tag, so moving an element never rehashes its key. erase
+// doesn't move anything, so iterators to other elements stay valid.
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>,
+	size_t SlotsPerBucket = 4>
+class cuckoo_hash_map : private H, private E {
+	static_assert(SlotsPerBucket > 0 && SlotsPerBucket <= 16, "cuckoo_hash_map supports 1 to 16 slots per bucket.");
+	using Bucket = detailv3::cuckoo_bucket<std::pair<K, V>, SlotsPerBucket>;
+	using BucketAlloc = typename std::allocator_traits<A>::template rebind_alloc<Bucket>;
+	using BucketTraits = std::allocator_traits<BucketAlloc>;
+	// how many elements an insert is willing to move to make room, and how many buckets it looks at finding them
+	static constexpr size_t max_path_length = 5;
+	static constexpr size_t max_search_buckets = 512;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+	static constexpr size_t slots_per_bucket = SlotsPerBucket;
+
+	template<typename ValueType> struct templated_iterator {
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ValueType;
+		using difference_type = ptrdiff_t;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+
+		templated_iterator() = default;
+		// starts at the first live slot at or after the given one
+		templated_iterator(Bucket* bucket, size_t slot, Bucket* end_bucket) : bucket(bucket), slot(slot), end_bucket(end_bucket) {
+			skip_empty_slots();
+		}
+		Bucket* bucket = nullptr;
+		size_t slot = 0;
+		Bucket* end_bucket = nullptr;
+
+		friend bool operator==(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return lhs.bucket == rhs.bucket && lhs.slot == rhs.slot;
+		}
+		friend bool operator!=(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return !(lhs == rhs);
+		}
+
+		templated_iterator& operator++() {
+			++slot;
+			skip_empty_slots();
+			return *this;
+		}
+		templated_iterator operator++(int32_t) {
+			templated_iterator copy(*this);
+			++*this;
+			return copy;
+		}
+
+		reference operator*() const {
+			return *bucket->slot(slot);
+		}
+		pointer operator->() const {
+			return bucket->slot(slot);
+		}
+
+		operator templated_iterator<const value_type>() const {
+			templated_iterator<const value_type> result;
+			result.bucket = bucket;
+			result.slot = slot;
+			result.end_bucket = end_bucket;
+			return result;
+		}
+
+	  private:
+		void skip_empty_slots() {
+			for (; bucket != end_bucket; ++bucket, slot = 0) {
+				for (; slot < SlotsPerBucket; ++slot) {
+					if (bucket->tags[slot])
+						return;
+				}
+			}
+			slot = 0;
+		}
+	};
+	using iterator = templated_iterator<value_type>;
+	using const_iterator = templated_iterator<const value_type>;
+
+	cuckoo_hash_map() {
+	}
+	explicit cuckoo_hash_map(size_type bucket_count, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+		: H(hash), E(equal), bucket_alloc(alloc) {
+		rehash(bucket_count);
+	}
+	cuckoo_hash_map(std::initializer_list<value_type> il) {
+		reserve(il.size());
+		for (auto& value: il)
+			insert(value);
+	}
+	cuckoo_hash_map(const cuckoo_hash_map& other)
+		: H(other), E(other), bucket_alloc(BucketTraits::select_on_container_copy_construction(other.bucket_alloc)),
+		  _max_load_factor(other._max_load_factor) {
+		reserve(other.size());
+		for (auto& value: other)
+			insert(value);
+	}
+	cuckoo_hash_map(cuckoo_hash_map&& other) noexcept : H(std::move(other)), E(std::move(other)), bucket_alloc(std::move(other.bucket_alloc)) {
+		swap_pointers(other);
+	}
+	// the buckets only ever go back to the allocator that made them, so an allocator that doesn't propagate and doesn't
+	// compare equal gets the elements copied or moved over one at a time, the way sherwood_v3_table does it
+	cuckoo_hash_map& operator=(const cuckoo_hash_map& other) {
+		if (this == std::addressof(other))
+			return *this;
+		clear();
+		if constexpr (BucketTraits::propagate_on_container_copy_assignment::value) {
+			if (bucket_alloc != other.bucket_alloc)
+				release_buckets();
+			bucket_alloc = other.bucket_alloc;
+		}
+		static_cast<H&>(*this) = other;
+		static_cast<E&>(*this) = other;
+		_max_load_factor = other._max_load_factor;
+		reserve(other.size());
+		for (auto& value: other)
+			insert(value);
+		return *this;
+	}
+	cuckoo_hash_map& operator=(cuckoo_hash_map&& other) noexcept(
+		BucketTraits::propagate_on_container_move_assignment::value || BucketTraits::is_always_equal::value) {
+		if (this == std::addressof(other))
+			return *this;
+		if constexpr (BucketTraits::propagate_on_container_move_assignment::value) {
+			clear();
+			release_buckets();
+			bucket_alloc = std::move(other.bucket_alloc);
+			swap_pointers(other);
+		} else if (bucket_alloc == other.bucket_alloc) {
+			swap_pointers(other);
+		} else {
+			clear();
+			_max_load_factor = other._max_load_factor;
+			reserve(other.size());
+			for (auto& value: other)
+				emplace(std::move(value.first), std::move(value.second));
+			other.clear();
+		}
+		static_cast<H&>(*this) = std::move(static_cast<H&>(other));
+		static_cast<E&>(*this) = std::move(static_cast<E&>(other));
+		return *this;
+	}
+	~cuckoo_hash_map() {
+		clear();
+		release_buckets();
+	}
+
+	iterator begin() {
+		return { buckets, 0, buckets + num_buckets };
+	}
+	const_iterator begin() const {
+		return const_cast<cuckoo_hash_map*>(this)->begin();
+	}
+	iterator end() {
+		return { buckets + num_buckets, 0, buckets + num_buckets };
+	}
+	const_iterator end() const {
+		return const_cast<cuckoo_hash_map*>(this)->end();
+	}
+
+	iterator find(const K& key) {
+		if (num_buckets == 0)
+			return end();
+		size_t hash = detailv3::mix_hash(hash_object(key));
+		uint8_t tag = tag_for_hash(hash);
+		size_t first = hash & bucket_mask;
+		if (size_t slot = find_in_bucket(buckets[first], tag, key); slot != SlotsPerBucket)
+			return iterator_at(first, slot);
+		size_t second = alternate_bucket(first, tag);
+		if (size_t slot = find_in_bucket(buckets[second], tag, key); slot != SlotsPerBucket)
+			return iterator_at(second, slot);
+		return end();
+	}
+	const_iterator find(const K& key) const {
+		return const_cast<cuckoo_hash_map*>(this)->find(key);
+	}
+	size_t count(const K& key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+	bool contains(const K& key) const {
+		return count(key) != 0;
+	}
+
+	template<typename Key, typename... Args> std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+		size_t hash = detailv3::mix_hash(hash_object(key));
+		uint8_t tag = tag_for_hash(hash);
+		if (num_buckets) {
+			size_t first = hash & bucket_mask;
+			if (size_t slot = find_in_bucket(buckets[first], tag, key); slot != SlotsPerBucket)
+				return { iterator_at(first, slot), false };
+			size_t second = alternate_bucket(first, tag);
+			if (size_t slot = find_in_bucket(buckets[second], tag, key); slot != SlotsPerBucket)
+				return { iterator_at(second, slot), false };
+		}
+		if (num_elements + 1 > capacity() * static_cast<double>(_max_load_factor))
+			grow();
+		auto [bucket, slot] = make_room(hash, tag);
+		::new (static_cast<void*>(buckets[bucket].slot(slot)))
+			value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		buckets[bucket].tags[slot] = tag;
+		++num_elements;
+		return { iterator_at(bucket, slot), true };
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value.first, value.second);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value.first), std::move(value.second));
+	}
+	template<typename It> void insert(It begin, It end) {
+		for (; begin != end; ++begin)
+			insert(*begin);
+	}
+	V& operator[](const K& key) {
+		return emplace(key).first->second;
+	}
+	V& operator[](K&& key) {
+		return emplace(std::move(key)).first->second;
+	}
+	V& at(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+	const V& at(const K& key) const {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	iterator erase(const_iterator to_erase) {
+		destroy_slot(*to_erase.bucket, to_erase.slot);
+		--num_elements;
+		return { to_erase.bucket, to_erase.slot, buckets + num_buckets };
+	}
+	size_t erase(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			return 0;
+		erase(found);
+		return 1;
+	}
+
+	void clear() {
+		for (size_t x = 0; x < num_buckets; ++x) {
+			for (size_t slot = 0; slot < SlotsPerBucket; ++slot) {
+				if (buckets[x].tags[slot])
+					destroy_slot(buckets[x], slot);
+			}
+		}
+		num_elements = 0;
+	}
+
+	// num_buckets is rounded up to a power of two, and to enough buckets for the current elements
+	void rehash(size_t num_buckets) {
+		num_buckets = std::max(num_buckets, buckets_for(num_elements));
+		if (num_buckets == 0)
+			return;
+		num_buckets = std::bit_ceil(num_buckets);
+		if (num_buckets == this->num_buckets)
+			return;
+		cuckoo_hash_map new_map(0, static_cast<const H&>(*this), static_cast<const E&>(*this), A(bucket_alloc));
+		new_map._max_load_factor = _max_load_factor;
+		new_map.allocate_buckets(num_buckets);
+		for (size_t x = 0; x < this->num_buckets; ++x) {
+			for (size_t slot = 0; slot < SlotsPerBucket; ++slot) {
+				if (buckets[x].tags[slot]) {
+					new_map.place_new(std::move(*buckets[x].slot(slot)));
+					destroy_slot(buckets[x], slot);
+				}
+			}
+		}
+		num_elements = 0;
+		swap_pointers(new_map);
+	}
+	void reserve(size_t num_elements) {
+		size_t required_buckets = buckets_for(num_elements);
+		if (required_buckets > num_buckets)
+			rehash(required_buckets);
+	}
+
+	void swap(cuckoo_hash_map& other) {
+		using std::swap;
+		swap(static_cast<H&>(*this), static_cast<H&>(other));
+		swap(static_cast<E&>(*this), static_cast<E&>(other));
+		swap_pointers(other);
+		if constexpr (BucketTraits::propagate_on_container_swap::value)
+			swap(bucket_alloc, other.bucket_alloc);
+	}
+
+	size_t size() const {
+		return num_elements;
+	}
+	bool empty() const {
+		return num_elements == 0;
+	}
+	size_t bucket_count() const {
+		return num_buckets;
+	}
+	// slots, which is buckets times SlotsPerBucket
+	size_t capacity() const {
+		return num_buckets * SlotsPerBucket;
+	}
+	float load_factor() const {
+		return num_buckets ? static_cast<float>(num_elements) / capacity() : 0;
+	}
+	void max_load_factor(float value) {
+		_max_load_factor = value;
+	}
+	float max_load_factor() const {
+		return _max_load_factor;
+	}
+	// bytes held by the bucket array
+	size_t memory_usage() const {
+		return num_buckets * sizeof(Bucket);
+	}
+
+  private:
+	Bucket* buckets = nullptr;
+	size_t num_buckets = 0;
+	size_t bucket_mask = 0;
+	size_t num_elements = 0;
+	float _max_load_factor = 0.95f;
+	BucketAlloc bucket_alloc;
+
+	struct slot_position {
+		size_t bucket;
+		size_t slot;
+	};
+
+	size_t buckets_for(size_t num_elements) const {
+		return static_cast<size_t>(std::ceil(num_elements / (static_cast<double>(_max_load_factor) * SlotsPerBucket)));
+	}
+
+	void swap_pointers(cuckoo_hash_map& other) {
+		using std::swap;
+		swap(buckets, other.buckets);
+		swap(num_buckets, other.num_buckets);
+		swap(bucket_mask, other.bucket_mask);
+		swap(num_elements, other.num_elements);
+		swap(_max_load_factor, other._max_load_factor);
+	}
+
+	void allocate_buckets(size_t count) {
+		buckets = BucketTraits::allocate(bucket_alloc, count);
+		for (size_t x = 0; x < count; ++x) {
+			std::memset(buckets[x].tags, 0, sizeof(buckets[x].tags));
+		}
+		num_buckets = count;
+		bucket_mask = count - 1;
+	}
+	void release_buckets() {
+		if (buckets) {
+			BucketTraits::deallocate(bucket_alloc, buckets, num_buckets);
+		}
+		buckets = nullptr;
+		num_buckets = 0;
+		bucket_mask = 0;
+	}
+
+	void grow() {
+		rehash(std::max(size_t(2), 2 * num_buckets));
+	}
+
+	// places an element whose key is known not to be in the table yet
+	void place_new(value_type&& value) {
+		size_t hash = detailv3::mix_hash(hash_object(value.first));
+		uint8_t tag = tag_for_hash(hash);
+		auto [bucket, slot] = make_room(hash, tag);
+		::new (static_cast<void*>(buckets[bucket].slot(slot))) value_type(std::move(value));
+		buckets[bucket].tags[slot] = tag;
+		++num_elements;
+	}
+
+	// a free slot in one of the key's two buckets, moving other elements out of the way or growing the table as needed
+	slot_position make_room(size_t hash, uint8_t tag) {
+		for (;;) {
+			size_t first = hash & bucket_mask;
+			size_t second = alternate_bucket(first, tag);
+			if (size_t slot = free_slot(buckets[first]); slot != SlotsPerBucket)
+				return { first, slot };
+			if (size_t slot = free_slot(buckets[second]); slot != SlotsPerBucket)
+				return { second, slot };
+			if (std::optional<slot_position> freed = evict(first, second))
+				return *freed;
+			grow();
+		}
+	}
+
+	// breadth first search from both of the key's buckets for a bucket with a free slot, where each step goes from a
+	// bucket to the other bucket of one of its elements. the elements along the path found are then moved one step each,
+	// starting from the free end, which leaves a free slot in one of the key's buckets
+	std::optional<slot_position> evict(size_t first, size_t second) {
+		struct search_node {
+			size_t bucket;
+			uint32_t parent;
+			uint8_t slot;
+			uint8_t depth;
+		};
+		search_node queue[max_search_buckets];
+		size_t head = 0, tail = 0;
+		queue[tail++] = { first, 0, 0, 0 };
+		queue[tail++] = { second, 0, 0, 0 };
+		for (; head < tail; ++head) {
+			search_node node = queue[head];
+			if (size_t slot = free_slot(buckets[node.bucket]); slot != SlotsPerBucket)
+				return move_along_path(queue, head, slot);
+			if (node.depth == max_path_length)
+				continue;
+			for (size_t slot = 0; slot < SlotsPerBucket && tail < max_search_buckets; ++slot) {
+				size_t next = alternate_bucket(node.bucket, buckets[node.bucket].tags[slot]);
+				queue[tail++] = { next, static_cast<uint32_t>(head), static_cast<uint8_t>(slot), static_cast<uint8_t>(node.depth + 1) };
+			}
+		}
+		return std::nullopt;
+	}
+	template<typename Node> std::optional<slot_position> move_along_path(const Node* queue, size_t index, size_t free) {
+		while (queue[index].depth > 0) {
+			const Node& node = queue[index];
+			Bucket& from = buckets[queue[node.parent].bucket];
+			// a bucket can show up on the path twice, in which case an earlier move may have taken this element away. every
+			// move so far took an element to its other bucket, so the table is still valid and the caller just grows it
+			Bucket& to = buckets[node.bucket];
+			if (!from.tags[node.slot] || to.tags[free] || alternate_bucket(queue[node.parent].bucket, from.tags[node.slot]) != node.bucket)
+				return std::nullopt;
+			::new (static_cast<void*>(to.slot(free))) value_type(std::move(*from.slot(node.slot)));
+			to.tags[free] = from.tags[node.slot];
+			destroy_slot(from, node.slot);
+			free = node.slot;
+			index = node.parent;
+		}
+		return slot_position{ queue[index].bucket, free };
+	}
+
+	static size_t free_slot(const Bucket& bucket) {
+		size_t slot = 0;
+		for (; slot < SlotsPerBucket && bucket.tags[slot]; ++slot) {
+		}
+		return slot;
+	}
+	template<typename U> size_t find_in_bucket(const Bucket& bucket, uint8_t tag, const U& key) const {
+		for (size_t slot = 0; slot < SlotsPerBucket; ++slot) {
+			if (bucket.tags[slot] == tag && compares_equal(key, bucket.slot(slot)->first))
+				return slot;
+		}
+		return SlotsPerBucket;
+	}
+
+	iterator iterator_at(size_t bucket, size_t slot) {
+		iterator result;
+		result.bucket = buckets + bucket;
+		result.slot = slot;
+		result.end_bucket = buckets + num_buckets;
+		return result;
+	}
+
+	void destroy_slot(Bucket& bucket, size_t slot) {
+		std::destroy_at(bucket.slot(slot));
+		bucket.tags[slot] = 0;
+	}
+
+	// the other bucket depends only on this one and the tag, and going from either bucket gets back to the other
+	size_t alternate_bucket(size_t bucket, uint8_t tag) const {
+		return (bucket ^ (static_cast<size_t>(tag) * 0xC6A4A7935BD1E995ull)) & bucket_mask;
+	}
+	// hashes get mixed before they come here. std::hash of an integer is the integer itself, which would put the tag in
+	// bits that are zero for small keys
+	static uint8_t tag_for_hash(size_t hash) {
+		uint8_t tag = static_cast<uint8_t>(hash >> 56);
+		return tag + (tag == 0);
+	}
+	template<typename U> size_t hash_object(const U& key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	template<typename L, typename R> bool compares_equal(const L& lhs, const R& rhs) const {
+		return static_cast<const E&>(*this)(lhs, rhs);
+	}
+};
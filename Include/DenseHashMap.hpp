@@ -0,0 +1,357 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// DenseHashMap.hpp - Header file for the dense_hash_map class.
+/// \file DenseHashMap.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+
+namespace detailv3 {
+	// a slot of dense_hash_map's index: where the pair sits in the value array, 16 bits of the key's hash so that most
+	// mismatches never touch that array, and the probe distance. eight bytes, so the index of a map with a few thousand
+	// entries stays in L2 no matter how big the pairs are.
+	struct dense_bucket {
+		bool has_value() const {
+			return distance_from_desired >= 0;
+		}
+		bool is_empty() const {
+			return distance_from_desired < 0;
+		}
+		bool is_at_desired_position() const {
+			return distance_from_desired <= 0;
+		}
+
+		uint32_t value_index = 0;
+		uint16_t hash_fragment = 0;
+		int8_t distance_from_desired = -1;
+	};
+}
+
+// keeps every key/value pair packed at the front of one vector and finds them through a robin hood index of 32 bit
+// positions. iterating is a walk over that vector with no empty slots in it, and erase fills the hole with the last
+// pair, so it stays packed. that also means erase moves a pair, and an iterator or reference to the last one is left
+// pointing at the wrong element. holds at most 2^32 - 1 pairs.
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>>
+class dense_hash_map : private H, private E {
+	using Bucket = detailv3::dense_bucket;
+	using BucketAlloc = typename std::allocator_traits<A>::template rebind_alloc<Bucket>;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+	using value_container = std::vector<value_type, A>;
+	using iterator = typename value_container::iterator;
+	using const_iterator = typename value_container::const_iterator;
+
+	dense_hash_map() {
+	}
+	explicit dense_hash_map(size_type bucket_count, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+		: H(hash), E(equal), values(alloc), buckets(BucketAlloc(alloc)) {
+		rehash(bucket_count);
+	}
+	dense_hash_map(std::initializer_list<value_type> il) {
+		reserve(il.size());
+		for (auto& value: il)
+			insert(value);
+	}
+	dense_hash_map(const dense_hash_map& other) = default;
+	dense_hash_map(dense_hash_map&& other) noexcept
+		: H(std::move(other)), E(std::move(other)), values(std::move(other.values)), buckets(std::move(other.buckets)),
+		  num_slots_minus_one(other.num_slots_minus_one), hash_policy(other.hash_policy), max_lookups(other.max_lookups),
+		  _max_load_factor(other._max_load_factor) {
+		other.reset_index();
+	}
+	dense_hash_map& operator=(dense_hash_map other) {
+		swap(other);
+		return *this;
+	}
+
+	iterator begin() {
+		return values.begin();
+	}
+	const_iterator begin() const {
+		return values.begin();
+	}
+	iterator end() {
+		return values.end();
+	}
+	const_iterator end() const {
+		return values.end();
+	}
+
+	iterator find(const K& key) {
+		Bucket* found = find_bucket(key);
+		return found ? values.begin() + found->value_index : values.end();
+	}
+	const_iterator find(const K& key) const {
+		return const_cast<dense_hash_map*>(this)->find(key);
+	}
+	size_t count(const K& key) const {
+		return const_cast<dense_hash_map*>(this)->find_bucket(key) ? 1 : 0;
+	}
+	bool contains(const K& key) const {
+		return count(key) != 0;
+	}
+
+	template<typename Key, typename... Args> std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+		size_t hash = hash_object(key);
+		if (num_slots_minus_one) {
+			uint16_t fragment = fragment_for_hash(hash);
+			Bucket* current = first_bucket(hash);
+			for (int8_t distance_from_desired = 0; current->distance_from_desired >= distance_from_desired; ++current, ++distance_from_desired) {
+				if (current->hash_fragment == fragment && compares_equal(key, values[current->value_index].first))
+					return { values.begin() + current->value_index, false };
+			}
+		}
+		if (values.size() == std::numeric_limits<uint32_t>::max())
+			throw std::length_error("dense_hash_map can't hold more than 2^32 - 1 elements.");
+		values.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		uint32_t value_index = static_cast<uint32_t>(values.size() - 1);
+		// either way the index is rebuilt from the value array, which already holds the new pair
+		if (num_slots_minus_one == 0 || values.size() > (num_slots_minus_one + 1) * static_cast<double>(_max_load_factor))
+			grow();
+		else if (!place_index(hash, value_index))
+			grow();
+		return { values.begin() + value_index, true };
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value.first, value.second);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value.first), std::move(value.second));
+	}
+	V& operator[](const K& key) {
+		return emplace(key).first->second;
+	}
+	V& operator[](K&& key) {
+		return emplace(std::move(key)).first->second;
+	}
+	V& at(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+	const V& at(const K& key) const {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	// the last pair moves into the erased one's place, so the returned iterator, which points at the same position,
+	// is the next one to visit when erasing in a loop
+	iterator erase(const_iterator to_erase) {
+		size_t position = static_cast<size_t>(to_erase - values.cbegin());
+		erase_bucket(bucket_for_value(hash_object(to_erase->first), static_cast<uint32_t>(position)));
+		return values.begin() + position;
+	}
+	size_t erase(const K& key) {
+		Bucket* found = find_bucket(key);
+		if (!found)
+			return 0;
+		erase_bucket(found);
+		return 1;
+	}
+
+	void clear() {
+		values.clear();
+		std::fill(buckets.begin(), buckets.end(), Bucket{});
+	}
+
+	void rehash(size_t num_buckets) {
+		num_buckets = std::max(num_buckets, static_cast<size_t>(std::ceil(values.size() / static_cast<double>(_max_load_factor))));
+		if (num_buckets == 0) {
+			reset_index();
+			return;
+		}
+		auto new_prime_index = hash_policy.next_size_over(num_buckets);
+		if (num_buckets == bucket_count())
+			return;
+		max_lookups = std::max(detailv3::min_lookups, detailv3::log2(num_buckets));
+		// one bucket past the last one a probe can fill, so a lookup that runs to max_lookups stays in the array
+		buckets.assign(num_buckets + static_cast<size_t>(max_lookups), Bucket{});
+		num_slots_minus_one = num_buckets - 1;
+		hash_policy.commit(new_prime_index);
+		for (size_t x = 0; x < values.size(); ++x) {
+			if (!place_index(hash_object(values[x].first), static_cast<uint32_t>(x))) {
+				grow();
+				return;
+			}
+		}
+	}
+	void reserve(size_t num_elements) {
+		values.reserve(num_elements);
+		size_t required_buckets = num_buckets_for_reserve(num_elements);
+		if (required_buckets > bucket_count())
+			rehash(required_buckets);
+	}
+
+	void swap(dense_hash_map& other) {
+		using std::swap;
+		swap(static_cast<H&>(*this), static_cast<H&>(other));
+		swap(static_cast<E&>(*this), static_cast<E&>(other));
+		swap(values, other.values);
+		swap(buckets, other.buckets);
+		swap(num_slots_minus_one, other.num_slots_minus_one);
+		swap(hash_policy, other.hash_policy);
+		swap(max_lookups, other.max_lookups);
+		swap(_max_load_factor, other._max_load_factor);
+	}
+
+	size_t size() const {
+		return values.size();
+	}
+	bool empty() const {
+		return values.empty();
+	}
+	size_t bucket_count() const {
+		return num_slots_minus_one ? num_slots_minus_one + 1 : 0;
+	}
+	float load_factor() const {
+		size_t buckets = bucket_count();
+		return buckets ? static_cast<float>(values.size()) / buckets : 0;
+	}
+	void max_load_factor(float value) {
+		_max_load_factor = value;
+	}
+	float max_load_factor() const {
+		return _max_load_factor;
+	}
+	// the pairs in iteration order, for code that wants to hand them on as a contiguous range
+	const value_container& values_container() const {
+		return values;
+	}
+	// bytes held by the value array and the index
+	size_t memory_usage() const {
+		return values.capacity() * sizeof(value_type) + buckets.capacity() * sizeof(Bucket);
+	}
+
+  private:
+	value_container values;
+	std::vector<Bucket, BucketAlloc> buckets;
+	size_t num_slots_minus_one = 0;
+	typename detailv3::HashPolicySelector<H>::type hash_policy;
+	int8_t max_lookups = detailv3::min_lookups - 1;
+	float _max_load_factor = 0.5f;
+
+	size_t num_buckets_for_reserve(size_t num_elements) const {
+		return static_cast<size_t>(std::ceil(num_elements / std::min(0.5, static_cast<double>(_max_load_factor))));
+	}
+
+	void reset_index() {
+		buckets.clear();
+		num_slots_minus_one = 0;
+		hash_policy.reset();
+		max_lookups = detailv3::min_lookups - 1;
+	}
+
+	Bucket* first_bucket(size_t hash) {
+		return buckets.data() + hash_policy.index_for_hash(hash, num_slots_minus_one);
+	}
+
+	Bucket* find_bucket(const K& key) {
+		if (values.empty())
+			return nullptr;
+		size_t hash = hash_object(key);
+		uint16_t fragment = fragment_for_hash(hash);
+		Bucket* current = first_bucket(hash);
+		for (int8_t distance_from_desired = 0; current->distance_from_desired >= distance_from_desired; ++current, ++distance_from_desired) {
+			if (current->hash_fragment == fragment && compares_equal(key, values[current->value_index].first))
+				return current;
+		}
+		return nullptr;
+	}
+
+	// the bucket of a pair that is known to be in the map
+	Bucket* bucket_for_value(size_t hash, uint32_t value_index) {
+		Bucket* current = first_bucket(hash);
+		while (current->value_index != value_index || current->is_empty())
+			++current;
+		return current;
+	}
+
+	// robin hood insert into the index. on running out of lookups it returns false, and the bucket it was carrying by
+	// then may not be the new one, so the caller has to rebuild the index from the value array
+	bool place_index(size_t hash, uint32_t value_index) {
+		Bucket to_insert{ value_index, fragment_for_hash(hash), 0 };
+		Bucket* current = first_bucket(hash);
+		for (int8_t distance_from_desired = 0;; ++current, ++distance_from_desired) {
+			if (distance_from_desired == max_lookups)
+				return false;
+			if (current->is_empty()) {
+				to_insert.distance_from_desired = distance_from_desired;
+				*current = to_insert;
+				return true;
+			} else if (current->distance_from_desired < distance_from_desired) {
+				to_insert.distance_from_desired = distance_from_desired;
+				std::swap(*current, to_insert);
+				distance_from_desired = to_insert.distance_from_desired;
+			}
+		}
+	}
+
+	// backward shift delete in the index, then the last pair moves into the hole and its bucket is pointed at it
+	void erase_bucket(Bucket* bucket) {
+		uint32_t erased_index = bucket->value_index;
+		Bucket* current = bucket;
+		for (Bucket* next = current + 1; !next->is_at_desired_position(); ++current, ++next) {
+			*current = *next;
+			--current->distance_from_desired;
+		}
+		*current = Bucket{};
+		uint32_t last_index = static_cast<uint32_t>(values.size() - 1);
+		if (erased_index != last_index) {
+			bucket_for_value(hash_object(values[last_index].first), last_index)->value_index = erased_index;
+			values[erased_index] = std::move(values[last_index]);
+		}
+		values.pop_back();
+	}
+
+	void grow() {
+		rehash(std::max(size_t(4), 2 * bucket_count()));
+	}
+
+	// folds the top 16 bits into the bottom ones, so the fragment still varies within a probe sequence whether the
+	// hash policy takes the index from the low bits (power_of_two) or the high ones (fibonacci)
+	static uint16_t fragment_for_hash(size_t hash) {
+		return static_cast<uint16_t>(hash ^ (hash >> 48));
+	}
+	template<typename U> size_t hash_object(const U& key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	template<typename L, typename R> bool compares_equal(const L& lhs, const R& rhs) const {
+		return static_cast<const E&>(*this)(lhs, rhs);
+	}
+};
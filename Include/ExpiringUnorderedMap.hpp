@@ -0,0 +1,343 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// ExpiringUnorderedMap.hpp - Header file for the TimingWheel and ExpiringUnorderedMap classes.
+/// \file ExpiringUnorderedMap.hpp
+
+#pragma once
+
+#include <UnorderedMap.hpp>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <array>
+#include <bit>
+
+namespace DiscordCoreAPI {
+
+	// a hierarchical timing wheel: four levels of 256 slots, level n's slots each covering 256^n ticks, and a list for
+	// deadlines more than 2^32 ticks out. a timer sits in the lowest level whose slot can tell its deadline apart from the
+	// wheel's own time, and moves down a level each time the wheel's time reaches the start of the slot it's in, so
+	// scheduling is O(1) and every timer is moved at most four times before it fires. bitmaps of the occupied slots let the
+	// wheel jump straight over stretches of time with nothing in them, rather than stepping through every tick.
+	template<typename TimerType> class TimingWheel {
+	  public:
+		using timer_type = TimerType;
+		using size_type = uint64_t;
+
+		inline static constexpr uint64_t slotBits{ 8 };
+		inline static constexpr uint64_t slotCount{ 1ull << slotBits };
+		inline static constexpr uint64_t levelCount{ 4 };
+
+		inline TimingWheel() = default;
+
+		// the next tick the wheel will fire timers for. a timer scheduled for before it fires on the next call to advance().
+		inline uint64_t time() const {
+			return wheelTime;
+		}
+
+		inline size_type size() const {
+			return timerCount;
+		}
+
+		inline bool empty() const {
+			return timerCount == 0;
+		}
+
+		inline void schedule(uint64_t deadline, timer_type&& timer) {
+			place(deadline, std::move(timer));
+			++timerCount;
+		}
+
+		// fires, by handing each one to fire, the timers due at or before now, at most maxTimers of them. whatever the budget
+		// leaves behind fires first next time. returns how many fired.
+		template<typename FireFunction> inline size_type advance(uint64_t now, size_type maxTimers, FireFunction&& fire) {
+			size_type fired{};
+			while (!overdue.empty()) {
+				if (fired == maxTimers) {
+					return fired;
+				}
+				auto timer = std::move(overdue.back().timer);
+				overdue.pop_back();
+				--timerCount;
+				++fired;
+				fire(std::move(timer));
+			}
+			while (wheelTime <= now) {
+				auto& slot = levels[0].slots[wheelTime & (slotCount - 1)];
+				while (!slot.timers.empty()) {
+					if (fired == maxTimers) {
+						return fired;
+					}
+					auto timer = std::move(slot.timers.back().timer);
+					slot.timers.pop_back();
+					--timerCount;
+					++fired;
+					fire(std::move(timer));
+				}
+				levels[0].markEmpty(wheelTime & (slotCount - 1));
+				moveTo(std::min(nextEvent(), now + 1));
+			}
+			return fired;
+		}
+
+		inline void clear() {
+			for (auto& level: levels) {
+				for (auto& slot: level.slots) {
+					slot.timers.clear();
+				}
+				level.occupied = {};
+			}
+			overflow.clear();
+			overdue.clear();
+			timerCount = 0;
+		}
+
+	  protected:
+		struct ScheduledTimer {
+			uint64_t deadline;
+			timer_type timer;
+		};
+
+		struct Slot {
+			std::vector<ScheduledTimer> timers{};
+		};
+
+		struct Level {
+			std::array<Slot, slotCount> slots{};
+			std::array<uint64_t, slotCount / 64> occupied{};
+
+			inline void markOccupied(uint64_t index) {
+				occupied[index / 64] |= 1ull << (index % 64);
+			}
+
+			inline void markEmpty(uint64_t index) {
+				occupied[index / 64] &= ~(1ull << (index % 64));
+			}
+
+			// the first occupied slot at or after index, or slotCount.
+			inline uint64_t nextOccupied(uint64_t index) const {
+				for (uint64_t word = index / 64; word < occupied.size(); ++word) {
+					uint64_t bits = occupied[word] & (word == index / 64 ? ~0ull << (index % 64) : ~0ull);
+					if (bits) {
+						return word * 64 + std::countr_zero(bits);
+					}
+				}
+				return slotCount;
+			}
+		};
+
+		std::array<Level, levelCount> levels{};
+		std::vector<ScheduledTimer> overflow{};
+		std::vector<ScheduledTimer> overdue{};
+		std::vector<ScheduledTimer> cascading{};
+		uint64_t wheelTime{};
+		size_type timerCount{};
+
+		// the level is picked by the highest bit in which the deadline and the wheel's time differ.
+		inline void place(uint64_t deadline, timer_type&& timer) {
+			if (deadline < wheelTime) {
+				overdue.emplace_back(ScheduledTimer{ deadline, std::move(timer) });
+				return;
+			}
+			auto differingBits = deadline ^ wheelTime;
+			for (uint64_t level = 0; level < levelCount; ++level) {
+				if ((differingBits >> (slotBits * (level + 1))) == 0) {
+					auto index = (deadline >> (slotBits * level)) & (slotCount - 1);
+					levels[level].slots[index].timers.emplace_back(ScheduledTimer{ deadline, std::move(timer) });
+					levels[level].markOccupied(index);
+					return;
+				}
+			}
+			overflow.emplace_back(ScheduledTimer{ deadline, std::move(timer) });
+		}
+
+		// the first tick after wheelTime at which a slot fires or moves down a level, or the largest uint64_t. a slot further
+		// up always starts later than any slot below it, so the lowest occupied level decides.
+		inline uint64_t nextEvent() const {
+			for (uint64_t level = 0; level < levelCount; ++level) {
+				auto shift = slotBits * level;
+				auto index = levels[level].nextOccupied(((wheelTime >> shift) & (slotCount - 1)) + 1);
+				if (index < slotCount) {
+					auto windowShift = shift + slotBits;
+					auto windowStart = windowShift < 64 ? (wheelTime >> windowShift) << windowShift : 0;
+					return windowStart | (index << shift);
+				}
+			}
+			if (!overflow.empty()) {
+				return ((wheelTime >> (slotBits * levelCount)) + 1) << (slotBits * levelCount);
+			}
+			return std::numeric_limits<uint64_t>::max();
+		}
+
+		// nothing is due between wheelTime and time, so all that's left is to bring down the timers whose slots start at time.
+		inline void moveTo(uint64_t time) {
+			wheelTime = time;
+			if ((time & ((1ull << (slotBits * levelCount)) - 1)) == 0 && !overflow.empty()) {
+				cascading.swap(overflow);
+				for (auto& scheduled: cascading) {
+					place(scheduled.deadline, std::move(scheduled.timer));
+				}
+				cascading.clear();
+			}
+			for (uint64_t level = levelCount - 1; level > 0; --level) {
+				if ((time & ((1ull << (slotBits * level)) - 1)) == 0) {
+					auto index = (time >> (slotBits * level)) & (slotCount - 1);
+					auto& slot = levels[level].slots[index];
+					if (slot.timers.empty()) {
+						continue;
+					}
+					cascading.swap(slot.timers);
+					levels[level].markEmpty(index);
+					for (auto& scheduled: cascading) {
+						place(scheduled.deadline, std::move(scheduled.timer));
+					}
+					cascading.clear();
+				}
+			}
+		}
+	};
+
+	template<typename ValueType> struct ExpiringValue {
+		ValueType value;
+		uint64_t expiresAt;
+	};
+
+	// an UnorderedMap whose entries each expire at a deadline on a clock of the caller's choosing, milliseconds say, which
+	// only moves when tick() is called. an entry counts as gone from the moment the clock reaches its deadline. dropping
+	// it is left to a TimingWheel, which holds the key and deadline of every emplace, so it costs O(1) per entry whenever it
+	// happens, instead of a sweep over the whole map. tick(now) fires every timer that's due, or at most maxExpirations of
+	// them when given, and each emplace() or erase() fires a few more of whatever is still due, so a caller that ticks with
+	// a small budget spreads the work over the writes that follow. re-emplacing or erasing a key leaves its old timer in the
+	// wheel, and when that fires it finds the entry gone or not yet expired and leaves it be.
+	template<typename KeyType, typename ValueType> class ExpiringUnorderedMap {
+	  public:
+		using mapped_type = ValueType;
+		using key_type = KeyType;
+		using size_type = uint64_t;
+		using map_type = UnorderedMap<key_type, ExpiringValue<mapped_type>>;
+		using wheel_type = TimingWheel<key_type>;
+
+		inline static constexpr uint64_t neverExpires{ std::numeric_limits<uint64_t>::max() };
+		inline static constexpr size_type expirationsPerWrite{ 4 };
+
+		inline ExpiringUnorderedMap(uint64_t defaultTtlNew = neverExpires) : defaultTtl{ defaultTtlNew } {
+		}
+
+		// the same as emplaceWithTtl() with the default time to live.
+		template<typename key_type_new, typename... Args> inline void emplace(key_type_new&& key, Args&&... value) {
+			emplaceWithTtl(std::forward<key_type_new>(key), defaultTtl, std::forward<Args>(value)...);
+		}
+
+		// sets the key's value, which expires ttl ticks after the current time, or never for neverExpires.
+		template<typename key_type_new, typename... Args> inline void emplaceWithTtl(key_type_new&& key, uint64_t ttl, Args&&... value) {
+			expire(expirationsPerWrite);
+			auto expiresAt = ttl >= neverExpires - currentTime ? neverExpires : currentTime + ttl;
+			if (expiresAt != neverExpires) {
+				wheel.schedule(expiresAt, key_type{ key });
+			}
+			map.emplace(std::forward<key_type_new>(key), ExpiringValue<mapped_type>{ mapped_type{ std::forward<Args>(value)... }, expiresAt });
+		}
+
+		// the key's value, or nullptr when it's missing or has expired.
+		template<typename key_type_new> inline const mapped_type* find(key_type_new&& key) const {
+			auto iterator = map.find(std::forward<key_type_new>(key));
+			if (iterator == map.end() || iterator->second.expiresAt <= currentTime) {
+				return nullptr;
+			}
+			return &iterator->second.value;
+		}
+
+		template<typename key_type_new> inline mapped_type* find(key_type_new&& key) {
+			return const_cast<mapped_type*>(std::as_const(*this).find(std::forward<key_type_new>(key)));
+		}
+
+		template<typename key_type_new> inline const mapped_type& at(key_type_new&& key) const {
+			auto value = find(std::forward<key_type_new>(key));
+			if (!value) {
+				throw std::out_of_range{ "Sorry, but an object by that key doesn't exist in this map." };
+			}
+			return *value;
+		}
+
+		template<typename key_type_new> inline bool contains(key_type_new&& key) const {
+			return find(std::forward<key_type_new>(key)) != nullptr;
+		}
+
+		// when the key expires, which is neverExpires for a key that doesn't.
+		template<typename key_type_new> inline uint64_t expiresAt(key_type_new&& key) const {
+			auto iterator = map.find(std::forward<key_type_new>(key));
+			return iterator == map.end() ? currentTime : iterator->second.expiresAt;
+		}
+
+		template<typename key_type_new> inline void erase(key_type_new&& key) {
+			expire(expirationsPerWrite);
+			map.erase(std::forward<key_type_new>(key));
+		}
+
+		// moves the clock to now, if that's ahead of it, and fires up to maxExpirations of the timers that are due. returns
+		// how many entries that dropped.
+		inline size_type tick(uint64_t now, size_type maxExpirations = std::numeric_limits<size_type>::max()) {
+			currentTime = std::max(currentTime, now);
+			return expire(maxExpirations);
+		}
+
+		inline uint64_t now() const {
+			return currentTime;
+		}
+
+		// the entries not dropped yet, which can include some that have expired since the last tick() that drained the wheel.
+		inline size_type size() const {
+			return map.size();
+		}
+
+		inline bool empty() const {
+			return map.size() == 0;
+		}
+
+		inline void clear() {
+			map.clear();
+			wheel.clear();
+		}
+
+	  protected:
+		map_type map{};
+		wheel_type wheel{};
+		uint64_t currentTime{};
+		uint64_t defaultTtl{};
+
+		inline size_type expire(size_type maxExpirations) {
+			size_type dropped{};
+			wheel.advance(currentTime, maxExpirations, [&](key_type&& key) {
+				auto iterator = map.find(key);
+				if (iterator != map.end() && iterator->second.expiresAt <= currentTime) {
+					map.erase(iterator);
+					++dropped;
+				}
+			});
+			return dropped;
+		}
+	};
+}
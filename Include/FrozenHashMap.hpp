@@ -0,0 +1,274 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// FrozenHashMap.hpp - Header file for the frozen_hash_map class.
+/// \file FrozenHashMap.hpp
+
+#pragma once
+
+#include <type_traits>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <bit>
+#include <array>
+
+namespace detailv3 {
+	// a hash that's usable in constant expressions, so that the table of a frozen map can be laid out by the compiler.
+	// strings go in as whole words: eight bytes at a time, then the last eight bytes again overlapping the previous word,
+	// so there's no tail loop. a compile time read assembles the word a byte at a time, which gives the same value as the
+	// plain load used at run time on a little endian machine
+	constexpr uint64_t frozen_mix(uint64_t value) {
+		value ^= value >> 32;
+		value *= 0xD6E8FEB86659FD93ull;
+		value ^= value >> 32;
+		value *= 0xD6E8FEB86659FD93ull;
+		value ^= value >> 32;
+		return value;
+	}
+	template<typename Word> constexpr uint64_t frozen_read(const char* data) {
+		if (std::is_constant_evaluated() || std::endian::native != std::endian::little) {
+			uint64_t result = 0;
+			for (size_t x = 0; x < sizeof(Word); ++x) {
+				result |= static_cast<uint64_t>(static_cast<uint8_t>(data[x])) << (8 * x);
+			}
+			return result;
+		} else {
+			Word result;
+			std::memcpy(&result, data, sizeof(Word));
+			return result;
+		}
+	}
+	constexpr uint64_t frozen_hash(std::string_view key, uint64_t seed) {
+		const char* data = key.data();
+		size_t size = key.size();
+		uint64_t result = seed ^ (size * 0x9E3779B97F4A7C15ull);
+		uint64_t last = 0;
+		if (size >= 8) {
+			for (size_t x = 0; x + 8 < size; x += 8) {
+				result = (result ^ frozen_read<uint64_t>(data + x)) * 0x9E3779B97F4A7C15ull;
+				result ^= result >> 29;
+			}
+			last = frozen_read<uint64_t>(data + size - 8);
+		} else if (size >= 4) {
+			last = frozen_read<uint32_t>(data) | frozen_read<uint32_t>(data + size - 4) << 32;
+		} else if (size > 0) {
+			last = static_cast<uint64_t>(static_cast<uint8_t>(data[0])) | static_cast<uint64_t>(static_cast<uint8_t>(data[size / 2])) << 8 |
+				static_cast<uint64_t>(static_cast<uint8_t>(data[size - 1])) << 16;
+		}
+		return frozen_mix(result ^ last);
+	}
+	template<typename K> constexpr uint64_t frozen_hash(const K& key, uint64_t seed)
+		requires std::is_integral_v<K> || std::is_enum_v<K>
+	{
+		return frozen_mix(static_cast<uint64_t>(key) ^ seed);
+	}
+
+	// the high half of a 64 by 64 bit product, which maps a hash onto [0, range) without a division
+	constexpr uint64_t frozen_range(uint64_t hash, uint64_t range) {
+#if defined(__SIZEOF_INT128__)
+		return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * range) >> 64);
+#else
+		uint64_t hash_low = hash & 0xFFFFFFFFull, hash_high = hash >> 32;
+		uint64_t range_low = range & 0xFFFFFFFFull, range_high = range >> 32;
+		uint64_t middle = (hash_low * range_low >> 32) + (hash_high * range_low & 0xFFFFFFFFull) + (hash_low * range_high & 0xFFFFFFFFull);
+		return hash_high * range_high + (hash_high * range_low >> 32) + (hash_low * range_high >> 32) + (middle >> 32);
+#endif
+	}
+
+	// where everything goes in a frozen map. the keys are split into buckets by their hash, and each bucket gets a
+	// displacement that sends its keys to slots nobody else has taken. buckets are placed largest first, while most slots
+	// are still free, and a bucket of one key just gets the next free slot written down directly as -(slot + 1). with as
+	// many slots as keys the table is a minimal perfect hash, so the elements themselves can be stored in slot order.
+	template<size_t N> struct frozen_layout {
+		static constexpr size_t bucket_count = N / 2 > 0 ? N / 2 : 1;
+		static constexpr uint32_t max_displacement = 1u << 20;
+
+		uint64_t seed = 0;
+		std::array<int32_t, bucket_count> displacements{};
+		// order[slot] is the index of the element that goes into slot
+		std::array<size_t, N> order{};
+
+		static constexpr size_t bucket_for(uint64_t hash) {
+			return static_cast<size_t>(frozen_range(hash, bucket_count));
+		}
+		static constexpr size_t slot_for(uint64_t hash, int32_t displacement) {
+			return static_cast<size_t>(frozen_range((hash ^ static_cast<uint64_t>(displacement) * 0x9E3779B97F4A7C15ull) * 0xD6E8FEB86659FD93ull, N));
+		}
+
+		template<typename K> static constexpr frozen_layout build(const std::array<K, N>& keys) {
+			for (size_t x = 0; x < N; ++x) {
+				for (size_t y = x + 1; y < N; ++y) {
+					if (keys[x] == keys[y]) {
+						throw std::invalid_argument("frozen_hash_map was given the same key twice.");
+					}
+				}
+			}
+			for (uint64_t seed = 0;; ++seed) {
+				frozen_layout result{};
+				result.seed = seed * 0xA0761D6478BD642Full;
+				if (result.try_place(keys)) {
+					return result;
+				}
+			}
+		}
+
+	  private:
+		template<typename K> constexpr bool try_place(const std::array<K, N>& keys) {
+			std::array<uint64_t, N> hashes{};
+			std::array<size_t, bucket_count> sizes{};
+			std::array<size_t, N> by_bucket{};
+			for (size_t x = 0; x < N; ++x) {
+				hashes[x] = frozen_hash(keys[x], seed);
+				++sizes[bucket_for(hashes[x])];
+				by_bucket[x] = x;
+			}
+			std::sort(by_bucket.begin(), by_bucket.end(), [&](size_t lhs, size_t rhs) {
+				size_t lhs_bucket = bucket_for(hashes[lhs]), rhs_bucket = bucket_for(hashes[rhs]);
+				return sizes[lhs_bucket] != sizes[rhs_bucket] ? sizes[lhs_bucket] > sizes[rhs_bucket] : lhs_bucket < rhs_bucket;
+			});
+			std::array<bool, N> taken{};
+			size_t next_free = 0;
+			for (size_t begin = 0; begin < N;) {
+				size_t bucket = bucket_for(hashes[by_bucket[begin]]);
+				size_t end = begin + sizes[bucket];
+				if (sizes[bucket] == 1) {
+					while (taken[next_free]) {
+						++next_free;
+					}
+					taken[next_free] = true;
+					order[next_free] = by_bucket[begin];
+					displacements[bucket] = -static_cast<int32_t>(next_free) - 1;
+				} else if (!place_bucket(hashes, by_bucket, begin, end, bucket, taken)) {
+					return false;
+				}
+				begin = end;
+			}
+			return true;
+		}
+
+		constexpr bool place_bucket(const std::array<uint64_t, N>& hashes, const std::array<size_t, N>& by_bucket, size_t begin, size_t end, size_t bucket,
+			std::array<bool, N>& taken) {
+			for (int32_t displacement = 0; static_cast<uint32_t>(displacement) < max_displacement; ++displacement) {
+				size_t placed = begin;
+				for (; placed < end; ++placed) {
+					size_t slot = slot_for(hashes[by_bucket[placed]], displacement);
+					if (taken[slot]) {
+						break;
+					}
+					taken[slot] = true;
+				}
+				if (placed == end) {
+					for (size_t x = begin; x < end; ++x) {
+						order[slot_for(hashes[by_bucket[x]], displacement)] = by_bucket[x];
+					}
+					displacements[bucket] = displacement;
+					return true;
+				}
+				for (size_t x = begin; x < placed; ++x) {
+					taken[slot_for(hashes[by_bucket[x]], displacement)] = false;
+				}
+			}
+			return false;
+		}
+	};
+}
+
+// a read-only map over a key set that's known at compile time, string_view or integer keys. declared as
+// static constexpr the whole table lands in read-only data with nothing to build at startup, and a lookup is one hash,
+// one displacement and one key comparison, hit or miss. make one with make_frozen_hash_map()
+template<typename K, typename V, size_t N> class frozen_hash_map {
+	using Layout = detailv3::frozen_layout<N>;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using const_reference = const value_type&;
+	using const_iterator = const value_type*;
+	using iterator = const_iterator;
+
+	constexpr frozen_hash_map(const std::array<value_type, N>& source)
+		: frozen_hash_map(source, Layout::build(keys_of(source, std::make_index_sequence<N>{})), std::make_index_sequence<N>{}) {
+	}
+
+	constexpr const_iterator find(const K& key) const {
+		if constexpr (N == 0) {
+			return end();
+		} else {
+			uint64_t hash = detailv3::frozen_hash(key, seed);
+			int32_t displacement = displacements[Layout::bucket_for(hash)];
+			size_t slot = displacement < 0 ? static_cast<size_t>(-(displacement + 1)) : Layout::slot_for(hash, displacement);
+			return elements[slot].first == key ? elements.data() + slot : end();
+		}
+	}
+	constexpr bool contains(const K& key) const {
+		return find(key) != end();
+	}
+	constexpr size_t count(const K& key) const {
+		return contains(key) ? 1 : 0;
+	}
+	constexpr const V& at(const K& key) const {
+		const_iterator found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	// in slot order, not in the order they were given
+	constexpr const_iterator begin() const {
+		return elements.data();
+	}
+	constexpr const_iterator end() const {
+		return elements.data() + N;
+	}
+	constexpr size_t size() const {
+		return N;
+	}
+	constexpr bool empty() const {
+		return N == 0;
+	}
+
+  private:
+	uint64_t seed;
+	std::array<int32_t, Layout::bucket_count> displacements;
+	std::array<value_type, N> elements;
+
+	template<size_t... I> static constexpr std::array<K, N> keys_of(const std::array<value_type, N>& source, std::index_sequence<I...>) {
+		return { source[I].first... };
+	}
+	template<size_t... I> constexpr frozen_hash_map(const std::array<value_type, N>& source, const Layout& layout, std::index_sequence<I...>)
+		: seed(layout.seed), displacements(layout.displacements), elements{ source[layout.order[I]]... } {
+	}
+};
+
+template<typename K, typename V, size_t N> constexpr frozen_hash_map<K, V, N> make_frozen_hash_map(const std::pair<K, V> (&elements)[N]) {
+	return frozen_hash_map<K, V, N>(std::to_array(elements));
+}
@@ -4,8 +4,25 @@
 #pragma once
 
 #include <iostream>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <list>
 #include <HashMap.hpp>
 #include <UnorderedMap.hpp>
+#include <SmallUnorderedMap.hpp>
+#include <StringArenaMap.hpp>
+#include <SplitHashMap.hpp>
+#include <DenseHashMap.hpp>
+#include <SoaHashMap.hpp>
+#include <FrozenHashMap.hpp>
+#include <PerfectHashMap.hpp>
+#include <CuckooHashMap.hpp>
+#include <HopscotchHashMap.hpp>
+#include <PersistentMap.hpp>
+#include <ConcurrentMap.hpp>
+#include <ClockCache.hpp>
+#include <ExpiringUnorderedMap.hpp>
 #include <immintrin.h>
 #include <jsonifier/Index.hpp>
 
@@ -4,16 +4,25 @@
 
 #pragma once
 #include <jsonifier/Index.hpp>
+#include <SlotArrayPool.hpp>
+#include <BloomFilter.hpp>
+#include <HashMath.hpp>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <functional>
+#include <new>
 #include <cmath>
 #include <algorithm>
 #include <iterator>
 #include <utility>
 #include <type_traits>
+#include <memory>
+#include <bit>
+#include <memory_resource>
 
 #ifdef _MSC_VER
+#include <intrin.h>
 #define SKA_NOINLINE(...) __declspec(noinline) __VA_ARGS__
 #else
 #define SKA_NOINLINE(...) __VA_ARGS__ __attribute__((noinline))
@@ -21,6 +30,7 @@
 
 
 struct prime_number_hash_policy;
+struct fastmod_prime_hash_policy;
 struct power_of_two_hash_policy;
 struct fibonacci_hash_policy;
 
@@ -109,7 +119,28 @@ namespace detailv3 {
 		}
 	};
 	static constexpr int8_t min_lookups = 4;
-	template<typename T> struct sherwood_v3_entry {
+	// a hasher can ask for the full hash of every key to be kept next to it by declaring
+	// static constexpr bool store_hash = true. lookups then only compare keys whose hashes
+	// match, and growing the table never has to hash a key a second time
+	template<bool StoreHash> struct sherwood_v3_entry_hash {
+		static constexpr bool stores_hash = false;
+		bool hash_matches(size_t) const {
+			return true;
+		}
+		void set_hash(size_t) {
+		}
+	};
+	template<> struct sherwood_v3_entry_hash<true> {
+		static constexpr bool stores_hash = true;
+		bool hash_matches(size_t other) const {
+			return hash == other;
+		}
+		void set_hash(size_t value) {
+			hash = value;
+		}
+		size_t hash = 0;
+	};
+	template<typename T, bool StoreHash = false> struct sherwood_v3_entry : sherwood_v3_entry_hash<StoreHash> {
 		sherwood_v3_entry() {
 		}
 		sherwood_v3_entry(int8_t distance_from_desired) : distance_from_desired(distance_from_desired) {
@@ -175,6 +206,17 @@ namespace detailv3 {
 		}
 	};
 
+	// types whose bytes can be moved to a new address with a memcpy, leaving nothing behind that needs destroying.
+	// specialize this for your own types if they don't point into themselves. (libstdc++'s std::string does)
+	template<typename T> struct is_trivially_relocatable
+		: std::integral_constant<bool, std::is_trivially_move_constructible<T>::value && std::is_trivially_destructible<T>::value> {};
+	template<typename F, typename S> struct is_trivially_relocatable<std::pair<F, S>>
+		: std::integral_constant<bool, is_trivially_relocatable<F>::value && is_trivially_relocatable<S>::value> {};
+
+	// std::pair isn't trivially copyable because of its assignment operators, but copy construction is all we need
+	template<typename T> struct is_trivially_copy_constructible_entry
+		: std::integral_constant<bool, std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value> {};
+
 	inline size_t next_power_of_two(size_t i) {
 		--i;
 		i |= i >> 1;
@@ -196,12 +238,141 @@ namespace detailv3 {
 		typedef typename T::hash_policy type;
 	};
 
+	template<typename T, typename = void> struct StoreHashSelector : std::false_type {};
+	template<typename T> struct StoreHashSelector<T, void_t<decltype(T::store_hash)>> : std::integral_constant<bool, T::store_hash> {};
+
+	// a hasher can ask for a bitmap with one bit per slot by declaring static constexpr bool occupancy_bitmap = true.
+	// inserts and erases keep it up to date, and iterators use it to jump straight to the next live slot, 64 slots
+	// per word, instead of reading every slot in between. that's what makes walking a sparse table cheap
+	template<typename T, typename = void> struct OccupancyBitmapSelector : std::false_type {};
+	template<typename T> struct OccupancyBitmapSelector<T, void_t<decltype(T::occupancy_bitmap)>>
+		: std::integral_constant<bool, T::occupancy_bitmap> {};
+
+	// a hasher can ask for a blocked bloom filter next to the slot array by declaring static constexpr bool
+	// negative_lookup_filter = true. find() asks the filter first and only probes the table when it says the key may be
+	// there, so a lookup that misses usually costs one cache line instead of a walk over the key's probe sequence. erased
+	// keys drop out of it when a rehash resizes it, or when churn has put more keys through it than it was sized for
+	template<typename T, typename = void> struct NegativeLookupFilterSelector : std::false_type {};
+	template<typename T> struct NegativeLookupFilterSelector<T, void_t<decltype(T::negative_lookup_filter)>>
+		: std::integral_constant<bool, T::negative_lookup_filter> {};
+
+	// elements bigger than this many bytes live in a node of their own, and their slot holds a pointer to it. a wide slot
+	// spends most of every cache line a probe touches on bytes the probe never looks at, and growing the table has to
+	// move every element. a hasher can force the choice either way by declaring static constexpr bool node_storage
+	static constexpr size_t node_storage_threshold = 128;
+	template<typename T, typename H, typename = void> struct NodeStorageSelector
+		: std::integral_constant<bool, (sizeof(T) > node_storage_threshold) || !std::is_move_constructible<T>::value> {};
+	template<typename T, typename H> struct NodeStorageSelector<T, H, void_t<decltype(H::node_storage)>>
+		: std::integral_constant<bool, H::node_storage> {};
+
+	// what a slot holds in node mode. moving an element between slots is then a pointer copy, and the element itself
+	// keeps its address for as long as it's in the table, which also lets a map hold values that can't be moved at all
+	template<typename T> struct sherwood_v3_node {
+		T* pointer;
+	};
+	template<typename T, typename H> using sherwood_v3_stored = std::conditional_t<NodeStorageSelector<T, H>::value, sherwood_v3_node<T>, T>;
+	// node mode keeps the hash in the slot unless the hasher says otherwise, since a probe that compared keys straight
+	// away would follow the pointer of every entry it passes
+	template<typename T, typename H, typename = void> struct EntryStoresHash : NodeStorageSelector<T, H> {};
+	template<typename T, typename H> struct EntryStoresHash<T, H, void_t<decltype(H::store_hash)>> : std::integral_constant<bool, H::store_hash> {};
+	template<typename T, typename H> using sherwood_v3_entry_for = sherwood_v3_entry<sherwood_v3_stored<T, H>, EntryStoresHash<T, H>::value>;
+
+	// nodes come from the table's own allocator, except that the default ones get swapped for the per-thread node pool
+	template<typename T, typename A> struct node_allocator_for {
+		using type = typename std::allocator_traits<A>::template rebind_alloc<T>;
+	};
+	template<typename T, typename U> struct node_allocator_for<T, std::allocator<U>> {
+		using type = pooled_node_allocator<T>;
+	};
+	template<typename T, typename U> struct node_allocator_for<T, pooled_allocator<U>> {
+		using type = pooled_node_allocator<T>;
+	};
+
+	template<bool UseBitmap> struct sherwood_v3_occupancy {
+		static constexpr bool uses_bitmap = false;
+	};
+	template<> struct sherwood_v3_occupancy<true> {
+		static constexpr bool uses_bitmap = true;
+		// the end marker's bit is always set, so a scan for the next set bit never runs off the end
+		static uint64_t* empty_default_words() {
+			static uint64_t result[1] = { uint64_t(1) << (min_lookups - 1) };
+			return result;
+		}
+		static size_t word_count(size_t num_slots) {
+			return (num_slots + 63) / 64;
+		}
+		void mark_occupied(size_t index) {
+			occupancy_words[index >> 6] |= uint64_t(1) << (index & 63);
+		}
+		void mark_empty(size_t index) {
+			occupancy_words[index >> 6] &= ~(uint64_t(1) << (index & 63));
+		}
+
+		uint64_t* occupancy_words = empty_default_words();
+	};
+
+	// how an iterator gets from one live slot to the next. locate() returns the first live slot at or after current, and
+	// next() the one after that. without a bitmap that means reading every slot in between
+	template<typename EntryPointer, bool UseBitmap> struct sherwood_v3_occupancy_cursor {
+		EntryPointer locate(EntryPointer current) {
+			while (current->is_empty())
+				++current;
+			return current;
+		}
+		EntryPointer next(EntryPointer current) {
+			return locate(current + ptrdiff_t(1));
+		}
+	};
+	// with a bitmap the cursor keeps the not yet visited bits of the current word, so stepping to the next live slot is
+	// clearing the lowest bit and counting trailing zeros. the next position comes from the bits alone rather than from
+	// the slot the iterator is on, so a loop over the table isn't bound by the latency of reading each word
+	template<typename EntryPointer> struct sherwood_v3_occupancy_cursor<EntryPointer, true> {
+		sherwood_v3_occupancy_cursor() = default;
+		sherwood_v3_occupancy_cursor(EntryPointer entries, const uint64_t* words) : slots(entries), word(words) {
+		}
+
+		EntryPointer locate(EntryPointer current) {
+			size_t index = static_cast<size_t>(current - slots);
+			word += index / 64;
+			slots += static_cast<ptrdiff_t>(index & ~size_t(63));
+			bits = *word & (~uint64_t(0) << (index & 63));
+			return live();
+		}
+		EntryPointer next(EntryPointer) {
+			bits &= bits - 1;
+			return live();
+		}
+
+	  private:
+		EntryPointer live() {
+			while (bits == 0) {
+				bits = *++word;
+				slots += ptrdiff_t(64);
+			}
+			return slots + static_cast<ptrdiff_t>(std::countr_zero(bits));
+		}
+
+		// the slot that bit 0 of the current word stands for
+		EntryPointer slots = EntryPointer();
+		const uint64_t* word = nullptr;
+		uint64_t bits = 0;
+	};
+
 	template<typename T, typename FindKey, typename ArgumentHash, typename Hasher, typename ArgumentEqual, typename Equal, typename ArgumentAlloc,
 		typename EntryAlloc>
-	class sherwood_v3_table : private EntryAlloc, private Hasher, private Equal {
-		using Entry = detailv3::sherwood_v3_entry<T>;
+	class sherwood_v3_table : private EntryAlloc, private Hasher, private Equal, private sherwood_v3_occupancy<OccupancyBitmapSelector<ArgumentHash>::value>,
+							  private lookup_filter<NegativeLookupFilterSelector<ArgumentHash>::value> {
+		using Filter = lookup_filter<NegativeLookupFilterSelector<ArgumentHash>::value>;
+		static constexpr bool uses_nodes = NodeStorageSelector<T, ArgumentHash>::value;
+		using Stored = sherwood_v3_stored<T, ArgumentHash>;
+		using Entry = detailv3::sherwood_v3_entry_for<T, ArgumentHash>;
 		using AllocatorTraits = std::allocator_traits<EntryAlloc>;
+		using NodeAlloc = typename node_allocator_for<T, ArgumentAlloc>::type;
+		using NodeTraits = std::allocator_traits<NodeAlloc>;
 		using EntryPointer = typename AllocatorTraits::pointer;
+		using Occupancy = sherwood_v3_occupancy<OccupancyBitmapSelector<ArgumentHash>::value>;
+		using OccupancyCursor = sherwood_v3_occupancy_cursor<EntryPointer, Occupancy::uses_bitmap>;
+		using WordAlloc = typename AllocatorTraits::template rebind_alloc<uint64_t>;
 		struct convertible_to_iterator;
 
 		public:
@@ -256,16 +427,17 @@ namespace detailv3 {
 			: sherwood_v3_table(il, bucket_count, hash, ArgumentEqual(), alloc) {
 		}
 		sherwood_v3_table(const sherwood_v3_table& other)
-			: sherwood_v3_table(other, other.get_allocator()) {
+			: sherwood_v3_table(other, AllocatorTraits::select_on_container_copy_construction(other.get_allocator())) {
 		}
 		sherwood_v3_table(const sherwood_v3_table& other, const ArgumentAlloc& alloc)
-			: EntryAlloc(alloc), Hasher(other), Equal(other), _max_load_factor(other._max_load_factor) {
+			: EntryAlloc(alloc), Hasher(other), Equal(other), _max_load_factor(other._max_load_factor), _min_load_factor(other._min_load_factor) {
 			rehash_for_other_container(other);
 			try {
-				insert(other.begin(), other.end());
+				insert_from_other_container(other);
 			} catch (...) {
 				clear();
 				deallocate_data(entries, num_slots_minus_one, max_lookups);
+				release_occupancy();
 				throw;
 			}
 		}
@@ -288,10 +460,11 @@ namespace detailv3 {
 				AssignIfTrue<EntryAlloc, AllocatorTraits::propagate_on_container_copy_assignment::value>()(*this, other);
 			}
 			_max_load_factor = other._max_load_factor;
+			_min_load_factor = other._min_load_factor;
 			static_cast<Hasher&>(*this) = other;
 			static_cast<Equal&>(*this) = other;
 			rehash_for_other_container(other);
-			insert(other.begin(), other.end());
+			insert_from_other_container(other);
 			return *this;
 		}
 		sherwood_v3_table& operator=(sherwood_v3_table&& other) noexcept {
@@ -307,6 +480,7 @@ namespace detailv3 {
 			} else {
 				clear();
 				_max_load_factor = other._max_load_factor;
+				_min_load_factor = other._min_load_factor;
 				rehash_for_other_container(other);
 				for (T& elem: other)
 					emplace(std::move(elem));
@@ -319,6 +493,7 @@ namespace detailv3 {
 		~sherwood_v3_table() {
 			clear();
 			deallocate_data(entries, num_slots_minus_one, max_lookups);
+			release_occupancy();
 		}
 
 		const allocator_type& get_allocator() const {
@@ -331,9 +506,10 @@ namespace detailv3 {
 			return static_cast<const ArgumentHash&>(*this);
 		}
 
-		template<typename ValueType> struct templated_iterator {
+		template<typename ValueType> struct templated_iterator : private OccupancyCursor {
 			templated_iterator() = default;
-			templated_iterator(EntryPointer current) : current(current) {
+			// starts at the first live slot at or after position
+			templated_iterator(EntryPointer position, OccupancyCursor cursor) : OccupancyCursor(cursor), current(this->locate(position)) {
 			}
 			EntryPointer current = EntryPointer();
 
@@ -351,9 +527,7 @@ namespace detailv3 {
 			}
 
 			templated_iterator& operator++() {
-				do {
-					++current;
-				} while (current->is_empty());
+				current = this->next(current);
 				return *this;
 			}
 			templated_iterator operator++(int32_t) {
@@ -363,50 +537,47 @@ namespace detailv3 {
 			}
 
 			ValueType& operator*() const {
-				return current->value;
+				return element(current->value);
 			}
 			ValueType* operator->() const {
-				return std::addressof(current->value);
+				return std::addressof(element(current->value));
 			}
 
 			operator templated_iterator<const value_type>() const {
-				return { current };
+				return { current, static_cast<const OccupancyCursor&>(*this) };
 			}
 		};
 		using iterator = templated_iterator<value_type>;
 		using const_iterator = templated_iterator<const value_type>;
 
 		iterator begin() {
-			for (EntryPointer it = entries;; ++it) {
-				if (it->has_value())
-					return { it };
-			}
+			return { entries, occupancy_cursor() };
 		}
 		const_iterator begin() const {
-			for (EntryPointer it = entries;; ++it) {
-				if (it->has_value())
-					return { it };
-			}
+			return { entries, occupancy_cursor() };
 		}
 		const_iterator cbegin() const {
 			return begin();
 		}
 		iterator end() {
-			return { entries + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups) };
+			return { entries + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups), occupancy_cursor() };
 		}
 		const_iterator end() const {
-			return { entries + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups) };
+			return { entries + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups), occupancy_cursor() };
 		}
 		const_iterator cend() const {
 			return end();
 		}
 
 		iterator find(const FindKey& key) {
-			size_t index = hash_policy.index_for_hash(hash_object(key), num_slots_minus_one);
+			size_t hash = hash_object(key);
+			if (!this->filter_may_contain(hash))
+				return end();
+			size_t index = hash_policy.index_for_hash(hash, num_slots_minus_one);
 			EntryPointer it = entries + ptrdiff_t(index);
 			for (int8_t distance = 0; it->distance_from_desired >= distance; ++distance, ++it) {
-				if (compares_equal(key, it->value))
-					return { it };
+				if (it->hash_matches(hash) && compares_equal(key, element(it->value)))
+					return { it, occupancy_cursor() };
 			}
 			return end();
 		}
@@ -432,14 +603,8 @@ namespace detailv3 {
 		}
 
 		template<typename Key, typename... Args> std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
-			size_t index = hash_policy.index_for_hash(hash_object(key), num_slots_minus_one);
-			EntryPointer current_entry = entries + ptrdiff_t(index);
-			int8_t distance_from_desired = 0;
-			for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
-				if (compares_equal(key, current_entry->value))
-					return { { current_entry }, false };
-			}
-			return emplace_new_key(distance_from_desired, current_entry, std::forward<Key>(key), std::forward<Args>(args)...);
+			size_t hash = hash_object(key);
+			return emplace_hashed(hash, std::forward<Key>(key), std::forward<Args>(args)...);
 		}
 
 		std::pair<iterator, bool> insert(const value_type& value) {
@@ -482,6 +647,7 @@ namespace detailv3 {
 			for (EntryPointer it = new_buckets; it != special_end_item; ++it)
 				it->distance_from_desired = -1;
 			special_end_item->distance_from_desired = Entry::special_end_value;
+			uint64_t* old_words = replace_occupancy(num_buckets + new_max_lookups);
 			std::swap(entries, new_buckets);
 			std::swap(num_slots_minus_one, num_buckets);
 			--num_slots_minus_one;
@@ -489,13 +655,19 @@ namespace detailv3 {
 			int8_t old_max_lookups = max_lookups;
 			max_lookups = new_max_lookups;
 			num_elements = 0;
+			this->filter_reset(static_cast<size_t>((num_slots_minus_one + 1) * static_cast<double>(_max_load_factor)));
 			for (EntryPointer it = new_buckets, end = it + static_cast<ptrdiff_t>(num_buckets + old_max_lookups); it != end; ++it) {
 				if (it->has_value()) {
-					emplace(std::move(it->value));
-					it->destroy_value();
+					if constexpr (is_trivially_relocatable<Stored>::value) {
+						relocate_entry(it);
+					} else {
+						emplace_hashed(hash_of_entry(*it), std::move(it->value));
+						it->destroy_value();
+					}
 				}
 			}
 			deallocate_data(new_buckets, num_buckets, old_max_lookups);
+			deallocate_occupancy(old_words, num_buckets + old_max_lookups + 1);
 		}
 
 		void reserve(size_t num_elements) {
@@ -510,21 +682,21 @@ namespace detailv3 {
 		// next iterator, turn the return value into an iterator
 		convertible_to_iterator erase(const_iterator to_erase) {
 			EntryPointer current = to_erase.current;
-			current->destroy_value();
+			destroy_element(current);
 			--num_elements;
 			for (EntryPointer next = current + ptrdiff_t(1); !next->is_at_desired_position(); ++current, ++next) {
-				current->emplace(next->distance_from_desired - 1, std::move(next->value));
-				next->destroy_value();
+				construct_entry(current, next->distance_from_desired - 1, stored_hash(*next), std::move(next->value));
+				destroy_entry(next);
 			}
-			return { to_erase.current };
+			return { to_erase.current, occupancy_cursor() };
 		}
 
 		iterator erase(const_iterator begin_it, const_iterator end_it) {
 			if (begin_it == end_it)
-				return { begin_it.current };
+				return { begin_it.current, occupancy_cursor() };
 			for (EntryPointer it = begin_it.current, end = end_it.current; it != end; ++it) {
 				if (it->has_value()) {
-					it->destroy_value();
+					destroy_element(it);
 					--num_elements;
 				}
 			}
@@ -534,12 +706,12 @@ namespace detailv3 {
 			EntryPointer to_return = end_it.current - num_to_move;
 			for (EntryPointer it = end_it.current; !it->is_at_desired_position();) {
 				EntryPointer target = it - num_to_move;
-				target->emplace(it->distance_from_desired - num_to_move, std::move(it->value));
-				it->destroy_value();
+				construct_entry(target, it->distance_from_desired - num_to_move, stored_hash(*it), std::move(it->value));
+				destroy_entry(it);
 				++it;
 				num_to_move = std::min(static_cast<ptrdiff_t>(it->distance_from_desired), num_to_move);
 			}
-			return { to_return };
+			return { to_return, occupancy_cursor() };
 		}
 
 		size_t erase(const FindKey& key) {
@@ -548,28 +720,36 @@ namespace detailv3 {
 				return 0;
 			else {
 				erase(found);
+				if (num_elements < bucket_count() * static_cast<double>(_min_load_factor))
+					shrink_to_fit();
 				return 1;
 			}
 		}
 
 		void clear() {
-			for (EntryPointer it = entries, end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
-				if (it->has_value())
-					it->destroy_value();
-			}
+			OccupancyCursor cursor = occupancy_cursor();
+			for (EntryPointer it = cursor.locate(entries), end = entries + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end;
+				 it = cursor.next(it))
+				destroy_element(it);
 			num_elements = 0;
+			this->filter_clear();
 		}
 
 		void shrink_to_fit() {
 			rehash_for_other_container(*this);
 		}
+		// the flat tables own nothing besides the slot array, so this is shrink_to_fit(). string_arena_map's
+		// version also repacks its key arena
+		void compact() {
+			shrink_to_fit();
+		}
 
 		void swap(sherwood_v3_table& other) {
 			using std::swap;
 			swap_pointers(other);
 			swap(static_cast<ArgumentHash&>(*this), static_cast<ArgumentHash&>(other));
 			swap(static_cast<ArgumentEqual&>(*this), static_cast<ArgumentEqual&>(other));
-			if (AllocatorTraits::propagate_on_container_swap::value)
+			if constexpr (AllocatorTraits::propagate_on_container_swap::value)
 				swap(static_cast<EntryAlloc&>(*this), static_cast<EntryAlloc&>(other));
 		}
 
@@ -601,6 +781,16 @@ namespace detailv3 {
 		float max_load_factor() const {
 			return _max_load_factor;
 		}
+		// opt in to shrinking on erase: once erase(key) leaves the table less than this full it gets rebuilt at the
+		// size shrink_to_fit() picks. capped at a quarter of max_load_factor() so that the rebuilt table starts well
+		// above it and a size that hovers around the threshold doesn't rebuild over and over. erasing through an
+		// iterator never shrinks, so erase-while-iterating loops stay valid. 0, the default, turns it off
+		void min_load_factor(float value) {
+			_min_load_factor = std::clamp(value, 0.0f, _max_load_factor / 4);
+		}
+		float min_load_factor() const {
+			return _min_load_factor;
+		}
 
 		bool empty() const {
 			return num_elements == 0;
@@ -612,6 +802,7 @@ namespace detailv3 {
 		typename HashPolicySelector<ArgumentHash>::type hash_policy;
 		int8_t max_lookups = detailv3::min_lookups - 1;
 		float _max_load_factor = 0.5f;
+		float _min_load_factor = 0.0f;
 		size_t num_elements = 0;
 
 		static int8_t compute_max_lookups(size_t num_buckets) {
@@ -626,6 +817,71 @@ namespace detailv3 {
 			rehash(std::min(num_buckets_for_reserve(other.size()), other.bucket_count()));
 		}
 
+		// expects this table to be empty and freshly sized by rehash_for_other_container(). if we ended up
+		// with the same layout as the other table then the slot array can be copied over wholesale
+		void insert_from_other_container(const sherwood_v3_table& other) {
+			if constexpr (!uses_nodes && is_trivially_copy_constructible_entry<T>::value) {
+				if (num_slots_minus_one && num_slots_minus_one == other.num_slots_minus_one && max_lookups == other.max_lookups) {
+					std::memcpy(static_cast<void*>(std::addressof(*entries)), static_cast<const void*>(std::addressof(*other.entries)),
+						sizeof(Entry) * (num_slots_minus_one + max_lookups + 1));
+					if constexpr (Occupancy::uses_bitmap) {
+						std::memcpy(this->occupancy_words, other.occupancy_words, sizeof(uint64_t) * Occupancy::word_count(num_slots_minus_one + max_lookups + 1));
+					}
+					num_elements = other.num_elements;
+					static_cast<Filter&>(*this) = other;
+					return;
+				}
+			}
+			insert(other.begin(), other.end());
+		}
+
+		// moves an element from the old slot array during rehash() by copying its bytes. the keys
+		// are already known to be unique, so this skips the comparisons that emplace() would do
+		void relocate_entry(EntryPointer source) {
+			alignas(Stored) unsigned char to_insert[sizeof(Stored)];
+			size_t hash = hash_of_entry(*source);
+			size_t index = hash_policy.index_for_hash(hash, num_slots_minus_one);
+			this->filter_insert(hash);
+			std::memcpy(to_insert, static_cast<const void*>(std::addressof(source->value)), sizeof(Stored));
+			source->distance_from_desired = -1;
+			EntryPointer current_entry = entries + ptrdiff_t(index);
+			for (int8_t distance_from_desired = 0; num_slots_minus_one && distance_from_desired < max_lookups; ++current_entry, ++distance_from_desired) {
+				if (current_entry->is_empty()) {
+					std::memcpy(static_cast<void*>(std::addressof(current_entry->value)), to_insert, sizeof(Stored));
+					current_entry->distance_from_desired = distance_from_desired;
+					current_entry->set_hash(hash);
+					set_occupied(current_entry);
+					++num_elements;
+					return;
+				} else if (current_entry->distance_from_desired < distance_from_desired) {
+					alignas(Stored) unsigned char displaced[sizeof(Stored)];
+					std::memcpy(displaced, static_cast<const void*>(std::addressof(current_entry->value)), sizeof(Stored));
+					std::memcpy(static_cast<void*>(std::addressof(current_entry->value)), to_insert, sizeof(Stored));
+					std::memcpy(to_insert, displaced, sizeof(Stored));
+					std::swap(distance_from_desired, current_entry->distance_from_desired);
+					swap_hash(hash, *current_entry);
+				}
+			}
+			// ran out of lookups, so let emplace() grow the table like it normally would. the element in hand is usually
+			// one that got displaced, and unless the entries store it, hash is still the one the source element came with
+			Stored* overflow = std::launder(reinterpret_cast<Stored*>(to_insert));
+			if constexpr (!Entry::stores_hash) {
+				hash = hash_object(element(*overflow));
+			}
+			emplace_hashed(hash, std::move(*overflow));
+			overflow->~Stored();
+		}
+
+		// see lookup_filter::filter_needs_refill()
+		void refill_filter() {
+			this->filter_refill_start();
+			for (EntryPointer it = entries, end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
+				if (it->has_value()) {
+					this->filter_refill_insert(hash_of_entry(*it));
+				}
+			}
+		}
+
 		void swap_pointers(sherwood_v3_table& other) {
 			using std::swap;
 			swap(hash_policy, other.hash_policy);
@@ -634,44 +890,211 @@ namespace detailv3 {
 			swap(num_elements, other.num_elements);
 			swap(max_lookups, other.max_lookups);
 			swap(_max_load_factor, other._max_load_factor);
+			swap(_min_load_factor, other._min_load_factor);
+			if constexpr (Occupancy::uses_bitmap) {
+				swap(this->occupancy_words, other.occupancy_words);
+			}
+			this->filter_swap(other);
+		}
+
+		template<typename Key, typename... Args> std::pair<iterator, bool> emplace_hashed(size_t hash, Key&& key, Args&&... args) {
+			size_t index = hash_policy.index_for_hash(hash, num_slots_minus_one);
+			EntryPointer current_entry = entries + ptrdiff_t(index);
+			int8_t distance_from_desired = 0;
+			for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+				if (current_entry->hash_matches(hash) && compares_equal(key_view(key), element(current_entry->value)))
+					return { { current_entry, occupancy_cursor() }, false };
+			}
+			return emplace_new_key(hash, distance_from_desired, current_entry, std::forward<Key>(key), std::forward<Args>(args)...);
 		}
 
 		template<typename Key, typename... Args> SKA_NOINLINE(std::pair<iterator, bool>)
-		emplace_new_key(int8_t distance_from_desired, EntryPointer current_entry, Key&& key, Args&&... args) {
+		emplace_new_key(size_t hash, int8_t distance_from_desired, EntryPointer current_entry, Key&& key, Args&&... args) {
 			using std::swap;
 			if (num_slots_minus_one == 0 || distance_from_desired == max_lookups ||
 				num_elements + 1 > (num_slots_minus_one + 1) * static_cast<double>(_max_load_factor)) {
 				grow();
-				return emplace(std::forward<Key>(key), std::forward<Args>(args)...);
-			} else if (current_entry->is_empty()) {
-				current_entry->emplace(distance_from_desired, std::forward<Key>(key), std::forward<Args>(args)...);
+				return emplace_hashed(hash, std::forward<Key>(key), std::forward<Args>(args)...);
+			}
+			if (this->filter_needs_refill()) {
+				refill_filter();
+			}
+			this->filter_insert(hash);
+			if (current_entry->is_empty()) {
+				construct_entry(current_entry, distance_from_desired, hash, std::forward<Key>(key), std::forward<Args>(args)...);
 				++num_elements;
-				return { { current_entry }, true };
+				return { { current_entry, occupancy_cursor() }, true };
 			}
-			value_type to_insert(std::forward<Key>(key), std::forward<Args>(args)...);
+			Stored to_insert = make_stored(std::forward<Key>(key), std::forward<Args>(args)...);
 			swap(distance_from_desired, current_entry->distance_from_desired);
 			swap(to_insert, current_entry->value);
-			iterator result = { current_entry };
+			swap_hash(hash, *current_entry);
+			iterator result = { current_entry, occupancy_cursor() };
 			for (++distance_from_desired, ++current_entry;; ++current_entry) {
 				if (current_entry->is_empty()) {
-					current_entry->emplace(distance_from_desired, std::move(to_insert));
+					construct_entry(current_entry, distance_from_desired, hash, std::move(to_insert));
 					++num_elements;
 					return { result, true };
 				} else if (current_entry->distance_from_desired < distance_from_desired) {
 					swap(distance_from_desired, current_entry->distance_from_desired);
 					swap(to_insert, current_entry->value);
+					swap_hash(hash, *current_entry);
 					++distance_from_desired;
 				} else {
 					++distance_from_desired;
 					if (distance_from_desired == max_lookups) {
 						swap(to_insert, result.current->value);
+						swap_hash(hash, *result.current);
 						grow();
-						return emplace(std::move(to_insert));
+						return emplace_hashed(hash, std::move(to_insert));
 					}
 				}
 			}
 		}
 
+		// goes through the allocator so that a polymorphic_allocator can hand its resource down to
+		// keys and values that take one, like std::pmr::string
+		template<typename... Args> void construct_entry(EntryPointer entry, int8_t distance_from_desired, size_t hash, Args&&... args) {
+			if constexpr (uses_nodes) {
+				AllocatorTraits::construct(*this, std::addressof(entry->value), make_stored(std::forward<Args>(args)...));
+			} else {
+				AllocatorTraits::construct(*this, std::addressof(entry->value), std::forward<Args>(args)...);
+			}
+			entry->distance_from_desired = distance_from_desired;
+			entry->set_hash(hash);
+			set_occupied(entry);
+		}
+		// empties a slot whose contents have been moved elsewhere
+		void destroy_entry(EntryPointer entry) {
+			entry->destroy_value();
+			set_empty(entry);
+		}
+		// empties a slot whose element is leaving the table, node and all
+		void destroy_element(EntryPointer entry) {
+			if constexpr (uses_nodes) {
+				NodeAlloc node_alloc = node_allocator();
+				NodeTraits::destroy(node_alloc, entry->value.pointer);
+				NodeTraits::deallocate(node_alloc, entry->value.pointer, 1);
+			}
+			destroy_entry(entry);
+		}
+
+		// in node mode a slot's contents only move around once they're built, so a Stored argument is passed along as is
+		// and anything else gets a new node
+		template<typename... Args> static constexpr bool is_stored_argument = sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, Stored> && ...);
+		template<typename... Args> Stored make_stored(Args&&... args) {
+			if constexpr (!uses_nodes) {
+				return std::make_obj_using_allocator<value_type>(static_cast<EntryAlloc&>(*this), std::forward<Args>(args)...);
+			} else if constexpr (is_stored_argument<Args...>) {
+				return Stored(std::forward<Args>(args)...);
+			} else {
+				NodeAlloc node_alloc = node_allocator();
+				T* pointer = NodeTraits::allocate(node_alloc, 1);
+				try {
+					NodeTraits::construct(node_alloc, pointer, std::forward<Args>(args)...);
+				} catch (...) {
+					NodeTraits::deallocate(node_alloc, pointer, 1);
+					throw;
+				}
+				return Stored{ pointer };
+			}
+		}
+		NodeAlloc node_allocator() {
+			if constexpr (std::is_constructible_v<NodeAlloc, const EntryAlloc&>) {
+				return NodeAlloc(static_cast<const EntryAlloc&>(*this));
+			} else {
+				return NodeAlloc();
+			}
+		}
+		static T& element(Stored& stored) {
+			if constexpr (uses_nodes) {
+				return *stored.pointer;
+			} else {
+				return stored;
+			}
+		}
+		static const T& element(const Stored& stored) {
+			if constexpr (uses_nodes) {
+				return *stored.pointer;
+			} else {
+				return stored;
+			}
+		}
+		// what a key handed to emplace_hashed() compares as. that's a node when rehash() or a displaced insert puts an
+		// element back in
+		template<typename U> static const U& key_view(const U& key) {
+			return key;
+		}
+		static const T& key_view(const sherwood_v3_node<T>& node) {
+			return *node.pointer;
+		}
+
+		OccupancyCursor occupancy_cursor() const {
+			if constexpr (Occupancy::uses_bitmap) {
+				return { entries, this->occupancy_words };
+			} else {
+				return {};
+			}
+		}
+		void set_occupied(EntryPointer entry) {
+			if constexpr (Occupancy::uses_bitmap) {
+				this->mark_occupied(static_cast<size_t>(entry - entries));
+			}
+		}
+		void set_empty(EntryPointer entry) {
+			if constexpr (Occupancy::uses_bitmap) {
+				this->mark_empty(static_cast<size_t>(entry - entries));
+			}
+		}
+		// swaps in a cleared bitmap for a new slot array of num_slots slots, end marker included, and hands back the
+		// old one. tables without a bitmap get nullptr
+		uint64_t* replace_occupancy(size_t num_slots) {
+			if constexpr (Occupancy::uses_bitmap) {
+				WordAlloc word_alloc(static_cast<EntryAlloc&>(*this));
+				size_t count = Occupancy::word_count(num_slots);
+				uint64_t* words = std::allocator_traits<WordAlloc>::allocate(word_alloc, count);
+				std::fill(words, words + count, uint64_t(0));
+				words[(num_slots - 1) >> 6] = uint64_t(1) << ((num_slots - 1) & 63);
+				return std::exchange(this->occupancy_words, words);
+			} else {
+				return nullptr;
+			}
+		}
+		void deallocate_occupancy(uint64_t* words, size_t num_slots) {
+			if constexpr (Occupancy::uses_bitmap) {
+				if (words != Occupancy::empty_default_words()) {
+					WordAlloc word_alloc(static_cast<EntryAlloc&>(*this));
+					std::allocator_traits<WordAlloc>::deallocate(word_alloc, words, Occupancy::word_count(num_slots));
+				}
+			}
+		}
+		void release_occupancy() {
+			if constexpr (Occupancy::uses_bitmap) {
+				deallocate_occupancy(std::exchange(this->occupancy_words, Occupancy::empty_default_words()), num_slots_minus_one + max_lookups + 1);
+			}
+		}
+
+		// the hash that travels with an entry when it moves. zero when the table doesn't store hashes
+		static size_t stored_hash(const Entry& entry) {
+			if constexpr (Entry::stores_hash) {
+				return entry.hash;
+			} else {
+				return 0;
+			}
+		}
+		static void swap_hash(size_t& hash, Entry& entry) {
+			if constexpr (Entry::stores_hash) {
+				std::swap(hash, entry.hash);
+			}
+		}
+		size_t hash_of_entry(const Entry& entry) {
+			if constexpr (Entry::stores_hash) {
+				return entry.hash;
+			} else {
+				return hash_object(element(entry.value));
+			}
+		}
+
 		void grow() {
 			rehash(std::max(size_t(4), 2 * bucket_count()));
 		}
@@ -684,6 +1107,8 @@ namespace detailv3 {
 
 		void reset_to_empty_state() {
 			deallocate_data(entries, num_slots_minus_one, max_lookups);
+			release_occupancy();
+			this->filter_release();
 			entries = Entry::empty_default_table();
 			num_slots_minus_one = 0;
 			hash_policy.reset();
@@ -702,18 +1127,13 @@ namespace detailv3 {
 
 		struct convertible_to_iterator {
 			EntryPointer it;
+			OccupancyCursor cursor;
 
 			operator iterator() {
-				if (it->has_value())
-					return { it };
-				else
-					return ++iterator{ it };
+				return { it, cursor };
 			}
 			operator const_iterator() {
-				if (it->has_value())
-					return { it };
-				else
-					return ++const_iterator{ it };
+				return { it, cursor };
 			}
 		};
 	};
@@ -1362,6 +1782,31 @@ struct prime_number_hash_policy {
 	mod_function current_mod_function = &mod0;
 };
 
+// same primes as prime_number_hash_policy, but instead of calling through a table of mod functions it keeps the
+// prime's reciprocal and reduces with detailv3::fastmod_reciprocal's few inlined multiplies
+struct fastmod_prime_hash_policy {
+	size_t index_for_hash(size_t hash, size_t /*num_slots_minus_one*/) const {
+		return reciprocal.remainder(hash);
+	}
+	size_t keep_in_range(size_t index, size_t num_slots_minus_one) const {
+		return index > num_slots_minus_one ? index_for_hash(index, num_slots_minus_one) : index;
+	}
+
+	size_t next_size_over(size_t& size) const {
+		prime_number_hash_policy().next_size_over(size);
+		return size;
+	}
+	void commit(size_t new_prime) {
+		reciprocal.commit(new_prime);
+	}
+	void reset() {
+		commit(1);
+	}
+
+	private:
+	detailv3::fastmod_reciprocal reciprocal;
+};
+
 struct power_of_two_hash_policy {
 	size_t index_for_hash(size_t hash, size_t num_slots_minus_one) const {
 		return hash & num_slots_minus_one;
@@ -1402,13 +1847,15 @@ struct fibonacci_hash_policy {
 	int8_t shift = 63;
 };
 
+template<typename K, typename V, typename H, typename E, typename A> class perfect_hash_map;
+
 template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>>
 class flat_hash_map : public detailv3::sherwood_v3_table<std::pair<K, V>, K, H, detailv3::KeyOrValueHasher<K, std::pair<K, V>, H>, E,
 							detailv3::KeyOrValueEquality<K, std::pair<K, V>, E>, A,
-							typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry<std::pair<K, V>>>> {
+							typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry_for<std::pair<K, V>, H>>> {
 	using Table = detailv3::sherwood_v3_table<std::pair<K, V>, K, H, detailv3::KeyOrValueHasher<K, std::pair<K, V>, H>, E,
 		detailv3::KeyOrValueEquality<K, std::pair<K, V>, E>, A,
-		typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry<std::pair<K, V>>>>;
+		typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry_for<std::pair<K, V>, H>>>;
 
 	public:
 	using key_type = K;
@@ -1460,6 +1907,14 @@ class flat_hash_map : public detailv3::sherwood_v3_table<std::pair<K, V>, K, H,
 		return insert_or_assign(std::move(key), std::forward<M>(m)).first;
 	}
 
+	// an immutable copy that finds every key with a single probe. see PerfectHashMap.hpp, which has to be included to use these
+	perfect_hash_map<K, V, H, E, A> freeze() const& {
+		return perfect_hash_map<K, V, H, E, A>(*this);
+	}
+	perfect_hash_map<K, V, H, E, A> freeze() && {
+		return perfect_hash_map<K, V, H, E, A>(std::move(*this));
+	}
+
 	friend bool operator==(const flat_hash_map& lhs, const flat_hash_map& rhs) {
 		if (lhs.size() != rhs.size())
 			return false;
@@ -1486,9 +1941,9 @@ class flat_hash_map : public detailv3::sherwood_v3_table<std::pair<K, V>, K, H,
 
 template<typename T, typename H = std::hash<T>, typename E = std::equal_to<T>, typename A = std::allocator<T>> class flat_hash_set
 	: public detailv3::sherwood_v3_table<T, T, H, detailv3::functor_storage<size_t, H>, E, detailv3::functor_storage<bool, E>, A,
-			typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry<T>>> {
+			typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry_for<T, H>>> {
 	using Table = detailv3::sherwood_v3_table<T, T, H, detailv3::functor_storage<size_t, H>, E, detailv3::functor_storage<bool, E>, A,
-		typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry<T>>>;
+		typename std::allocator_traits<A>::template rebind_alloc<detailv3::sherwood_v3_entry_for<T, H>>>;
 
 	public:
 	using key_type = T;
@@ -1528,6 +1983,49 @@ template<typename T, typename H = std::hash<T>, typename E = std::equal_to<T>, t
 };
 
 
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>>
+using pmr_flat_hash_map = flat_hash_map<K, V, H, E, std::pmr::polymorphic_allocator<std::pair<K, V>>>;
+
+template<typename T, typename H = std::hash<T>, typename E = std::equal_to<T>>
+using pmr_flat_hash_set = flat_hash_set<T, H, E, std::pmr::polymorphic_allocator<T>>;
+
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>>
+using pooled_flat_hash_map = flat_hash_map<K, V, H, E, pooled_allocator<std::pair<K, V>>>;
+
+template<typename T, typename H = std::hash<T>, typename E = std::equal_to<T>>
+using pooled_flat_hash_set = flat_hash_set<T, H, E, pooled_allocator<T>>;
+
 template<typename T> struct power_of_two_std_hash : std::hash<T> {
 	typedef power_of_two_hash_policy hash_policy;
 };
+
+template<typename T> struct prime_number_std_hash : std::hash<T> {
+	typedef prime_number_hash_policy hash_policy;
+};
+
+template<typename T> struct fastmod_prime_std_hash : std::hash<T> {
+	typedef fastmod_prime_hash_policy hash_policy;
+};
+
+// keeps each key's hash in its slot. worth it for keys that are slow to compare or to hash, like long strings
+template<typename T> struct store_hash_std_hash : std::hash<T> {
+	static constexpr bool store_hash = true;
+};
+
+// keeps a bit per slot so iterators skip empty runs a word at a time. worth it for tables that get walked while mostly empty
+template<typename T> struct occupancy_bitmap_std_hash : std::hash<T> {
+	static constexpr bool occupancy_bitmap = true;
+};
+
+template<typename T> struct node_storage_std_hash : std::hash<T> {
+	static constexpr bool node_storage = true;
+};
+
+template<typename T> struct inline_storage_std_hash : std::hash<T> {
+	static constexpr bool node_storage = false;
+};
+
+// keeps a bloom filter of the keys next to the table. worth it when most lookups are for keys that aren't there
+template<typename T> struct negative_filter_std_hash : std::hash<T> {
+	static constexpr bool negative_lookup_filter = true;
+};
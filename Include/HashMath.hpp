@@ -0,0 +1,88 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// HashMath.hpp - Header file for the arithmetic the hash tables share for turning hashes into slots.
+/// \file HashMath.hpp
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace detailv3 {
+	// the first round of murmur3's fmix64 finalizer. hashers that hand back the key itself, as std::hash does for
+	// integers, leave the high bits empty and the low ones in clumps; this spreads every input bit over the top half
+	inline uint64_t mix_hash(uint64_t hash) {
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	// the high 64 bits of a 64x64 bit product
+	inline uint64_t mul_high(uint64_t lhs, uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+		return static_cast<uint64_t>((static_cast<unsigned __int128>(lhs) * rhs) >> 64);
+#else
+		return __umulh(lhs, rhs);
+#endif
+	}
+
+	// hash % divisor without a division: keeps the divisor's 128 bit reciprocal M = ceil(2^128 / divisor) around and
+	// reduces with a few inlined multiplies, hash % divisor == ((M * hash mod 2^128) * divisor) >> 128. see Lemire, Kaser
+	// and Kurz, "Faster Remainder by Direct Computation" (2019). a divisor of 1, which the empty tables use, makes M wrap
+	// to 0 and every hash land in slot 0
+	struct fastmod_reciprocal {
+		uint64_t remainder(uint64_t hash) const {
+			uint64_t low_bits_low = magic_low * hash;
+			uint64_t low_bits_high = magic_high * hash + mul_high(magic_low, hash);
+			uint64_t bottom = mul_high(low_bits_low, divisor);
+			uint64_t top_low = low_bits_high * divisor;
+			return mul_high(low_bits_high, divisor) + (top_low + bottom < top_low);
+		}
+
+		void commit(uint64_t new_divisor) {
+			divisor = new_divisor;
+#if defined(__SIZEOF_INT128__)
+			unsigned __int128 magic = ~static_cast<unsigned __int128>(0) / new_divisor + 1;
+			magic_low = static_cast<uint64_t>(magic);
+			magic_high = static_cast<uint64_t>(magic >> 64);
+#else
+			uint64_t remainder;
+			magic_high = ~uint64_t(0) / new_divisor;
+			magic_low = _udiv128(~uint64_t(0) % new_divisor, ~uint64_t(0), new_divisor, &remainder);
+			magic_high += ++magic_low == 0;
+#endif
+		}
+
+		uint64_t divisor = 1;
+		uint64_t magic_low = 0;
+		uint64_t magic_high = 0;
+	};
+}
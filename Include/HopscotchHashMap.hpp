@@ -0,0 +1,518 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// HopscotchHashMap.hpp - Header file for the hopscotch_hash_map class.
+/// \file HopscotchHashMap.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace detailv3 {
+	// a slot, plus the neighborhood of the bucket that starts at it: bit i is set when the element in the slot i places
+	// further on has this bucket as its home. the bitmap sits in front of the slot it belongs to, so a lookup whose key is
+	// in its own home slot reads one cache line
+	template<typename T, typename Bitmap> struct hopscotch_entry {
+		T* value() {
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+		const T* value() const {
+			return std::launder(reinterpret_cast<const T*>(storage));
+		}
+
+		Bitmap neighborhood = 0;
+		bool occupied = false;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+}
+
+// hopscotch hashing: every element lives within NeighborhoodSize slots of its home bucket, and the home bucket's bitmap
+// says which of those slots hold its elements. a lookup only compares keys in the slots the bitmap flags, so a miss in
+// a full table costs as much as one in an empty one. an insert takes the nearest empty slot and, while that's too far
+// from home, swaps it backwards with an element that can move forward without leaving its own neighborhood. when no
+// such element exists the table grows. NeighborhoodSize is 32 or 64, and the default max_load_factor is 0.75 or 0.9 to go
+// with it.
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>,
+	size_t NeighborhoodSize = 32>
+class hopscotch_hash_map : private H, private E {
+	static_assert(NeighborhoodSize == 32 || NeighborhoodSize == 64, "hopscotch_hash_map supports neighborhoods of 32 or 64 slots.");
+	using Bitmap = std::conditional_t<NeighborhoodSize == 32, uint32_t, uint64_t>;
+	using Entry = detailv3::hopscotch_entry<std::pair<K, V>, Bitmap>;
+	using EntryAlloc = typename std::allocator_traits<A>::template rebind_alloc<Entry>;
+	using EntryTraits = std::allocator_traits<EntryAlloc>;
+	// how far past its home an insert looks for an empty slot before it gives up and grows the table
+	static constexpr size_t max_search_distance = NeighborhoodSize * 32;
+	// about as full as the table gets before an insert first finds no element it can move out of the way. with random
+	// keys that happened at 80% full with 32 slot neighborhoods and 91% with 64
+	static constexpr float default_max_load_factor = NeighborhoodSize == 32 ? 0.75f : 0.9f;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+	static constexpr size_t neighborhood_size = NeighborhoodSize;
+
+	template<typename ValueType> struct templated_iterator {
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ValueType;
+		using difference_type = ptrdiff_t;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+
+		templated_iterator() = default;
+		// starts at the first live slot at or after current
+		templated_iterator(Entry* current, Entry* end) : current(current), end(end) {
+			skip_empty_slots();
+		}
+		Entry* current = nullptr;
+		Entry* end = nullptr;
+
+		friend bool operator==(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return lhs.current == rhs.current;
+		}
+		friend bool operator!=(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return !(lhs == rhs);
+		}
+
+		templated_iterator& operator++() {
+			++current;
+			skip_empty_slots();
+			return *this;
+		}
+		templated_iterator operator++(int32_t) {
+			templated_iterator copy(*this);
+			++*this;
+			return copy;
+		}
+
+		reference operator*() const {
+			return *current->value();
+		}
+		pointer operator->() const {
+			return current->value();
+		}
+
+		operator templated_iterator<const value_type>() const {
+			return { current, end };
+		}
+
+	  private:
+		void skip_empty_slots() {
+			for (; current != end && !current->occupied; ++current) {
+			}
+		}
+	};
+	using iterator = templated_iterator<value_type>;
+	using const_iterator = templated_iterator<const value_type>;
+
+	hopscotch_hash_map() {
+	}
+	explicit hopscotch_hash_map(size_type bucket_count, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+		: H(hash), E(equal), entry_alloc(alloc) {
+		rehash(bucket_count);
+	}
+	hopscotch_hash_map(std::initializer_list<value_type> il) {
+		reserve(il.size());
+		for (auto& value: il)
+			insert(value);
+	}
+	hopscotch_hash_map(const hopscotch_hash_map& other)
+		: H(other), E(other), entry_alloc(EntryTraits::select_on_container_copy_construction(other.entry_alloc)), _max_load_factor(other._max_load_factor) {
+		reserve(other.size());
+		for (auto& value: other)
+			insert(value);
+	}
+	hopscotch_hash_map(hopscotch_hash_map&& other) noexcept : H(std::move(other)), E(std::move(other)), entry_alloc(std::move(other.entry_alloc)) {
+		swap_pointers(other);
+	}
+	// as in cuckoo_hash_map, the slots only ever go back to the allocator that made them
+	hopscotch_hash_map& operator=(const hopscotch_hash_map& other) {
+		if (this == std::addressof(other))
+			return *this;
+		clear();
+		if constexpr (EntryTraits::propagate_on_container_copy_assignment::value) {
+			if (entry_alloc != other.entry_alloc)
+				release_entries();
+			entry_alloc = other.entry_alloc;
+		}
+		static_cast<H&>(*this) = other;
+		static_cast<E&>(*this) = other;
+		_max_load_factor = other._max_load_factor;
+		reserve(other.size());
+		for (auto& value: other)
+			insert(value);
+		return *this;
+	}
+	hopscotch_hash_map& operator=(hopscotch_hash_map&& other) noexcept(
+		EntryTraits::propagate_on_container_move_assignment::value || EntryTraits::is_always_equal::value) {
+		if (this == std::addressof(other))
+			return *this;
+		if constexpr (EntryTraits::propagate_on_container_move_assignment::value) {
+			clear();
+			release_entries();
+			entry_alloc = std::move(other.entry_alloc);
+			swap_pointers(other);
+		} else if (entry_alloc == other.entry_alloc) {
+			swap_pointers(other);
+		} else {
+			clear();
+			_max_load_factor = other._max_load_factor;
+			reserve(other.size());
+			for (auto& value: other)
+				emplace(std::move(value.first), std::move(value.second));
+			other.clear();
+		}
+		static_cast<H&>(*this) = std::move(static_cast<H&>(other));
+		static_cast<E&>(*this) = std::move(static_cast<E&>(other));
+		return *this;
+	}
+	~hopscotch_hash_map() {
+		clear();
+		release_entries();
+	}
+
+	iterator begin() {
+		return { entries, entries + num_entries() };
+	}
+	const_iterator begin() const {
+		return const_cast<hopscotch_hash_map*>(this)->begin();
+	}
+	iterator end() {
+		return { entries + num_entries(), entries + num_entries() };
+	}
+	const_iterator end() const {
+		return const_cast<hopscotch_hash_map*>(this)->end();
+	}
+
+	iterator find(const K& key) {
+		if (num_buckets == 0)
+			return end();
+		Entry* home = entries + index_for_hash(hash_object(key));
+		if (Entry* found = find_in_neighborhood(home, key))
+			return iterator_at(found);
+		return end();
+	}
+	const_iterator find(const K& key) const {
+		return const_cast<hopscotch_hash_map*>(this)->find(key);
+	}
+	size_t count(const K& key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+	bool contains(const K& key) const {
+		return count(key) != 0;
+	}
+
+	template<typename Key, typename... Args> std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+		size_t hash = hash_object(key);
+		if (num_buckets) {
+			if (Entry* found = find_in_neighborhood(entries + index_for_hash(hash), key))
+				return { iterator_at(found), false };
+		}
+		if (num_elements + 1 > num_buckets * static_cast<double>(_max_load_factor))
+			grow();
+		Entry* home = make_room(hash);
+		Entry* slot = claim_slot(home);
+		::new (static_cast<void*>(slot->value()))
+			value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		slot->occupied = true;
+		++num_elements;
+		return { iterator_at(slot), true };
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value.first, value.second);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value.first), std::move(value.second));
+	}
+	template<typename It> void insert(It begin, It end) {
+		for (; begin != end; ++begin)
+			insert(*begin);
+	}
+	V& operator[](const K& key) {
+		return emplace(key).first->second;
+	}
+	V& operator[](K&& key) {
+		return emplace(std::move(key)).first->second;
+	}
+	V& at(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+	const V& at(const K& key) const {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	// nothing else moves, so iterators to other elements stay valid
+	iterator erase(const_iterator to_erase) {
+		Entry* current = to_erase.current;
+		Entry* home = entries + index_for_hash(hash_object(current->value()->first));
+		home->neighborhood &= ~(Bitmap(1) << (current - home));
+		destroy_slot(current);
+		--num_elements;
+		return { current, entries + num_entries() };
+	}
+	size_t erase(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			return 0;
+		erase(found);
+		return 1;
+	}
+
+	void clear() {
+		for (Entry *it = entries, *end = entries + num_entries(); it != end; ++it) {
+			if (it->occupied)
+				destroy_slot(it);
+			it->neighborhood = 0;
+		}
+		num_elements = 0;
+	}
+
+	// num_buckets is rounded up to a power of two, and to enough buckets for the current elements
+	void rehash(size_t num_buckets) {
+		num_buckets = std::max(num_buckets, static_cast<size_t>(std::ceil(num_elements / static_cast<double>(_max_load_factor))));
+		if (num_buckets == 0)
+			return;
+		num_buckets = std::bit_ceil(num_buckets);
+		if (num_buckets == this->num_buckets)
+			return;
+		hopscotch_hash_map new_map(0, static_cast<const H&>(*this), static_cast<const E&>(*this), A(entry_alloc));
+		new_map._max_load_factor = _max_load_factor;
+		new_map.allocate_entries(num_buckets);
+		for (Entry *it = entries, *end = entries + num_entries(); it != end; ++it) {
+			if (it->occupied) {
+				new_map.place_new(std::move(*it->value()));
+				destroy_slot(it);
+			}
+		}
+		num_elements = 0;
+		swap_pointers(new_map);
+	}
+	void reserve(size_t num_elements) {
+		size_t required_buckets = static_cast<size_t>(std::ceil(num_elements / static_cast<double>(_max_load_factor)));
+		if (required_buckets > num_buckets)
+			rehash(required_buckets);
+	}
+
+	void swap(hopscotch_hash_map& other) {
+		using std::swap;
+		swap(static_cast<H&>(*this), static_cast<H&>(other));
+		swap(static_cast<E&>(*this), static_cast<E&>(other));
+		swap_pointers(other);
+		if constexpr (EntryTraits::propagate_on_container_swap::value)
+			swap(entry_alloc, other.entry_alloc);
+	}
+
+	size_t size() const {
+		return num_elements;
+	}
+	bool empty() const {
+		return num_elements == 0;
+	}
+	size_t bucket_count() const {
+		return num_buckets;
+	}
+	float load_factor() const {
+		return num_buckets ? static_cast<float>(num_elements) / num_buckets : 0;
+	}
+	void max_load_factor(float value) {
+		_max_load_factor = value;
+	}
+	float max_load_factor() const {
+		return _max_load_factor;
+	}
+	// bytes held by the slot array, the NeighborhoodSize - 1 slots past the last bucket included
+	size_t memory_usage() const {
+		return num_entries() * sizeof(Entry);
+	}
+
+	// element x of the result is how many elements a successful lookup finds after comparing x keys, that is, one plus the
+	// number of flagged slots in front of the element's own in its home's neighborhood. walks the whole table, so it's
+	// meant for benchmarks and tuning rather than for calling alongside lookups
+	std::vector<size_t> probe_count_histogram() const {
+		std::vector<size_t> result(NeighborhoodSize + 1);
+		for (size_t x = 0; x < num_buckets; ++x) {
+			Bitmap neighborhood = entries[x].neighborhood;
+			for (size_t probes = 1; neighborhood; ++probes, neighborhood &= neighborhood - 1) {
+				++result[probes];
+			}
+		}
+		while (result.size() > 1 && result.back() == 0) {
+			result.pop_back();
+		}
+		return result;
+	}
+
+  private:
+	Entry* entries = nullptr;
+	size_t num_buckets = 0;
+	size_t bucket_mask = 0;
+	size_t num_elements = 0;
+	float _max_load_factor = default_max_load_factor;
+	EntryAlloc entry_alloc;
+
+	// the last bucket's neighborhood runs NeighborhoodSize - 1 slots past it, and the array goes that far too rather than
+	// wrapping around
+	size_t num_entries() const {
+		return num_buckets ? num_buckets + NeighborhoodSize - 1 : 0;
+	}
+
+	void swap_pointers(hopscotch_hash_map& other) {
+		using std::swap;
+		swap(entries, other.entries);
+		swap(num_buckets, other.num_buckets);
+		swap(bucket_mask, other.bucket_mask);
+		swap(num_elements, other.num_elements);
+		swap(_max_load_factor, other._max_load_factor);
+	}
+
+	void allocate_entries(size_t count) {
+		num_buckets = count;
+		bucket_mask = count - 1;
+		entries = EntryTraits::allocate(entry_alloc, num_entries());
+		for (Entry *it = entries, *end = entries + num_entries(); it != end; ++it) {
+			it->neighborhood = 0;
+			it->occupied = false;
+		}
+	}
+	void release_entries() {
+		if (entries) {
+			EntryTraits::deallocate(entry_alloc, entries, num_entries());
+		}
+		entries = nullptr;
+		num_buckets = 0;
+		bucket_mask = 0;
+	}
+
+	void grow() {
+		rehash(std::max(size_t(4), 2 * num_buckets));
+	}
+
+	template<typename U> Entry* find_in_neighborhood(Entry* home, const U& key) const {
+		for (Bitmap neighborhood = home->neighborhood; neighborhood; neighborhood &= neighborhood - 1) {
+			Entry* candidate = home + std::countr_zero(neighborhood);
+			if (compares_equal(key, candidate->value()->first))
+				return candidate;
+		}
+		return nullptr;
+	}
+
+	// places an element whose key is known not to be in the table yet
+	void place_new(value_type&& value) {
+		Entry* slot = claim_slot(make_room(hash_object(value.first)));
+		::new (static_cast<void*>(slot->value())) value_type(std::move(value));
+		slot->occupied = true;
+		++num_elements;
+	}
+
+	// the home bucket for hash, once there's an empty slot in its neighborhood, growing the table until there is
+	Entry* make_room(size_t hash) {
+		for (;;) {
+			Entry* home = entries + index_for_hash(hash);
+			Entry* empty = find_empty_slot(home);
+			if (empty && hop_towards(home, empty))
+				return home;
+			grow();
+		}
+	}
+	// flags the empty slot make_room() left in home's neighborhood as taken by home
+	Entry* claim_slot(Entry* home) {
+		Bitmap taken = 0;
+		for (Entry* it = home; it != home + NeighborhoodSize; ++it) {
+			taken |= Bitmap(it->occupied) << (it - home);
+		}
+		Entry* slot = home + std::countr_one(taken);
+		home->neighborhood |= Bitmap(1) << (slot - home);
+		return slot;
+	}
+
+	Entry* find_empty_slot(Entry* home) const {
+		Entry* end = std::min(home + max_search_distance, entries + num_entries());
+		for (Entry* it = home; it != end; ++it) {
+			if (!it->occupied)
+				return it;
+		}
+		return nullptr;
+	}
+	// moves the empty slot back until it's in home's neighborhood, each time by moving an element that's in front of it
+	// into it. the element has to stay within its own neighborhood, so it comes from one of the NeighborhoodSize - 1
+	// buckets before the empty slot, earliest bucket first, since that moves the empty slot furthest
+	Entry* hop_towards(Entry* home, Entry* empty) {
+		while (static_cast<size_t>(empty - home) >= NeighborhoodSize) {
+			Entry* moved_to = empty;
+			for (Entry* bucket = empty - (NeighborhoodSize - 1); bucket != empty; ++bucket) {
+				Bitmap movable = bucket->neighborhood & ((Bitmap(1) << (empty - bucket)) - 1);
+				if (movable) {
+					Entry* source = bucket + std::countr_zero(movable);
+					::new (static_cast<void*>(empty->value())) value_type(std::move(*source->value()));
+					empty->occupied = true;
+					destroy_slot(source);
+					bucket->neighborhood ^= (Bitmap(1) << (source - bucket)) | (Bitmap(1) << (empty - bucket));
+					moved_to = source;
+					break;
+				}
+			}
+			if (moved_to == empty)
+				return nullptr;
+			empty = moved_to;
+		}
+		return empty;
+	}
+
+	iterator iterator_at(Entry* entry) {
+		iterator result;
+		result.current = entry;
+		result.end = entries + num_entries();
+		return result;
+	}
+
+	void destroy_slot(Entry* entry) {
+		std::destroy_at(entry->value());
+		entry->occupied = false;
+	}
+
+	// std::hash of an integer is the integer itself, and keys that are multiples of some constant then land in a few
+	// clumps, which a neighborhood can't absorb the way a longer probe sequence would. so the hash gets mixed first
+	size_t index_for_hash(size_t hash) const {
+		return detailv3::mix_hash(hash) & bucket_mask;
+	}
+	template<typename U> size_t hash_object(const U& key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	template<typename L, typename R> bool compares_equal(const L& lhs, const R& rhs) const {
+		return static_cast<const E&>(*this)(lhs, rhs);
+	}
+};
@@ -0,0 +1,262 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// PerfectHashMap.hpp - Header file for the perfect_hash_map class.
+/// \file PerfectHashMap.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <FrozenHashMap.hpp>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+
+// an immutable map over a key set that's built once and then only read, usually made with flat_hash_map::freeze(). a
+// minimal perfect hash sends every key to its own slot of a packed array of pairs, so a lookup is the key's hash, one
+// 16 bit pilot and one probe, hit or miss. the index costs about 4 bits per key on top of the pairs themselves.
+//
+// the construction follows PTHash: keys are split into buckets of about five by their hash, and the buckets, largest
+// first, each search for a pilot that sends all their keys to free slots. there are 2% more slots than keys so the last
+// buckets still find room, and the few keys that land past the end are remapped into the holes that leaves below it.
+// holds at most 2^32 - 1 pairs.
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>>
+class perfect_hash_map : private H, private E {
+	using PilotAlloc = typename std::allocator_traits<A>::template rebind_alloc<uint16_t>;
+	using RemapAlloc = typename std::allocator_traits<A>::template rebind_alloc<uint32_t>;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+	using value_container = std::vector<value_type, A>;
+	using iterator = typename value_container::const_iterator;
+	using const_iterator = typename value_container::const_iterator;
+
+	static constexpr size_t keys_per_bucket = 5;
+	static constexpr uint32_t max_pilot = std::numeric_limits<uint16_t>::max();
+	static constexpr uint64_t max_seeds = 16;
+
+	perfect_hash_map() {
+	}
+	explicit perfect_hash_map(const flat_hash_map<K, V, H, E, A>& map)
+		: H(map.hash_function()), E(map.key_eq()), values(map.begin(), map.end(), A(map.get_allocator())), pilots(PilotAlloc(values.get_allocator())),
+		  remap(RemapAlloc(values.get_allocator())) {
+		build();
+	}
+	explicit perfect_hash_map(flat_hash_map<K, V, H, E, A>&& map)
+		: H(map.hash_function()), E(map.key_eq()), values(A(map.get_allocator())), pilots(PilotAlloc(values.get_allocator())),
+		  remap(RemapAlloc(values.get_allocator())) {
+		values.reserve(map.size());
+		for (auto& value: map)
+			values.emplace_back(std::move(value));
+		map.clear();
+		build();
+	}
+
+	const_iterator begin() const {
+		return values.begin();
+	}
+	const_iterator end() const {
+		return values.end();
+	}
+
+	const_iterator find(const K& key) const {
+		if (values.empty())
+			return values.end();
+		size_t slot = slot_for_hash(mixed_hash(static_cast<const H&>(*this)(key)));
+		return static_cast<const E&>(*this)(values[slot].first, key) ? values.begin() + static_cast<ptrdiff_t>(slot) : values.end();
+	}
+	size_t count(const K& key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+	bool contains(const K& key) const {
+		return count(key) != 0;
+	}
+	const V& at(const K& key) const {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	size_t size() const {
+		return values.size();
+	}
+	bool empty() const {
+		return values.empty();
+	}
+	const H& hash_function() const {
+		return static_cast<const H&>(*this);
+	}
+	const E& key_eq() const {
+		return static_cast<const E&>(*this);
+	}
+	const value_container& values_container() const {
+		return values;
+	}
+
+	// the index alone, without the pairs it points into
+	double bits_per_key() const {
+		return values.empty() ? 0.0 : static_cast<double>(pilots.size() * 16 + remap.size() * 32) / static_cast<double>(values.size());
+	}
+	size_t memory_usage() const {
+		return values.capacity() * sizeof(value_type) + pilots.capacity() * sizeof(uint16_t) + remap.capacity() * sizeof(uint32_t);
+	}
+
+  private:
+	value_container values;
+	std::vector<uint16_t, PilotAlloc> pilots;
+	// for every slot past the end of values, where the key that landed there went instead
+	std::vector<uint32_t, RemapAlloc> remap;
+	uint64_t seed = 0;
+	size_t num_slots = 0;
+
+	uint64_t mixed_hash(size_t hash) const {
+		return detailv3::frozen_mix(static_cast<uint64_t>(hash) ^ seed);
+	}
+	size_t bucket_for_hash(uint64_t hash) const {
+		return static_cast<size_t>(detailv3::frozen_range(hash, pilots.size()));
+	}
+	// the bucket comes from the high bits of the hash, so the product spreads the low bits up before they pick a slot
+	size_t position_for(uint64_t hash, uint32_t pilot) const {
+		return static_cast<size_t>(detailv3::frozen_range((hash ^ pilot * 0x9E3779B97F4A7C15ull) * 0xD6E8FEB86659FD93ull, num_slots));
+	}
+	size_t slot_for_hash(uint64_t hash) const {
+		size_t position = position_for(hash, pilots[bucket_for_hash(hash)]);
+		return position < values.size() ? position : remap[position - values.size()];
+	}
+
+	void build() {
+		if (values.size() > std::numeric_limits<uint32_t>::max())
+			throw std::length_error("perfect_hash_map holds at most 2^32 - 1 pairs.");
+		if (values.empty())
+			return;
+		std::vector<size_t> hashes(values.size());
+		for (size_t x = 0; x < values.size(); ++x)
+			hashes[x] = static_cast<const H&>(*this)(values[x].first);
+		std::vector<uint32_t> positions(values.size());
+		for (uint64_t attempt = 0; attempt < max_seeds; ++attempt) {
+			seed = attempt * 0xA0761D6478BD642Full;
+			if (place_keys(hashes, positions)) {
+				// move every pair into its slot by following the cycles of the permutation
+				using std::swap;
+				for (size_t x = 0; x < values.size(); ++x) {
+					while (positions[x] != x) {
+						size_t target = positions[x];
+						swap(values[x], values[target]);
+						swap(positions[x], positions[target]);
+					}
+				}
+				return;
+			}
+		}
+		throw std::runtime_error("perfect_hash_map couldn't tell some keys apart. the hasher probably gives them the same hash.");
+	}
+
+	bool place_keys(const std::vector<size_t>& hashes, std::vector<uint32_t>& positions) {
+		size_t num_keys = values.size();
+		size_t num_buckets = (num_keys + keys_per_bucket - 1) / keys_per_bucket;
+		num_slots = num_keys + num_keys / 50 + 1;
+		pilots.assign(num_buckets, 0);
+		std::vector<uint64_t> mixed(num_keys);
+		// the keys grouped by bucket with a counting sort, then the buckets ordered largest first with another
+		std::vector<uint32_t> bucket_start(num_buckets + 1, 0);
+		for (size_t x = 0; x < num_keys; ++x) {
+			mixed[x] = mixed_hash(hashes[x]);
+			++bucket_start[bucket_for_hash(mixed[x]) + 1];
+		}
+		size_t largest = 0;
+		for (size_t x = 0; x < num_buckets; ++x) {
+			largest = std::max<size_t>(largest, bucket_start[x + 1]);
+			bucket_start[x + 1] += bucket_start[x];
+		}
+		std::vector<uint32_t> by_bucket(num_keys);
+		{
+			std::vector<uint32_t> fill(bucket_start.begin(), bucket_start.end() - 1);
+			for (size_t x = 0; x < num_keys; ++x)
+				by_bucket[fill[bucket_for_hash(mixed[x])]++] = static_cast<uint32_t>(x);
+		}
+		std::vector<uint32_t> size_start(largest + 2, 0);
+		for (size_t x = 0; x < num_buckets; ++x)
+			++size_start[largest - (bucket_start[x + 1] - bucket_start[x]) + 1];
+		for (size_t x = 0; x <= largest; ++x)
+			size_start[x + 1] += size_start[x];
+		std::vector<uint32_t> bucket_order(num_buckets);
+		for (size_t x = 0; x < num_buckets; ++x)
+			bucket_order[size_start[largest - (bucket_start[x + 1] - bucket_start[x])]++] = static_cast<uint32_t>(x);
+
+		std::vector<uint64_t> taken((num_slots + 63) / 64, 0);
+		auto is_taken = [&](size_t position) {
+			return (taken[position / 64] >> (position % 64)) & 1;
+		};
+		auto flip = [&](size_t position) {
+			taken[position / 64] ^= uint64_t(1) << (position % 64);
+		};
+		for (uint32_t bucket: bucket_order) {
+			size_t begin = bucket_start[bucket], end = bucket_start[bucket + 1];
+			if (begin == end)
+				break;
+			uint32_t pilot = 0;
+			for (; pilot <= max_pilot; ++pilot) {
+				size_t placed = begin;
+				for (; placed < end; ++placed) {
+					size_t position = position_for(mixed[by_bucket[placed]], pilot);
+					if (is_taken(position))
+						break;
+					flip(position);
+				}
+				if (placed == end)
+					break;
+				for (size_t x = begin; x < placed; ++x)
+					flip(position_for(mixed[by_bucket[x]], pilot));
+			}
+			if (pilot > max_pilot)
+				return false;
+			pilots[bucket] = static_cast<uint16_t>(pilot);
+			for (size_t x = begin; x < end; ++x)
+				positions[by_bucket[x]] = static_cast<uint32_t>(position_for(mixed[by_bucket[x]], pilot));
+		}
+
+		// every slot past the end that got a key means a hole below it, so pair them up in order
+		remap.assign(num_slots - num_keys, 0);
+		size_t hole = 0;
+		for (size_t position = num_keys; position < num_slots; ++position) {
+			if (is_taken(position)) {
+				while (is_taken(hole))
+					++hole;
+				remap[position - num_keys] = static_cast<uint32_t>(hole++);
+			}
+		}
+		for (uint32_t& position: positions) {
+			if (position >= num_keys)
+				position = remap[position - num_keys];
+		}
+		return true;
+	}
+};
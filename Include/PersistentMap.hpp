@@ -0,0 +1,590 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// PersistentMap.hpp - Header file for the PersistentMap class.
+/// \file PersistentMap.hpp
+
+#pragma once
+
+#include <UnorderedMap.hpp>
+#include <stdexcept>
+#include <atomic>
+#include <new>
+#include <bit>
+
+namespace DiscordCoreAPI {
+
+	// a node of PersistentMap's trie. dataMap flags the five bit hash fragments whose pair sits in this node and nodeMap
+	// the ones that lead to a child, and a fragment's place in either array is the popcount of the flags below its own. the
+	// child pointers and then the pairs follow the node in the same allocation. once all 64 bits of the hash are used up,
+	// a node is a collision node instead: collisionCount pairs whose keys hash the same, and no bitmaps.
+	template<typename ValueType> struct TrieNode {
+		using value_type = ValueType;
+
+		std::atomic<uint32_t> refCount{ 1 };
+		uint32_t dataMap{};
+		uint32_t nodeMap{};
+		uint32_t collisionCount{};
+
+		inline uint32_t dataCount() const {
+			return collisionCount ? collisionCount : static_cast<uint32_t>(std::popcount(dataMap));
+		}
+
+		inline uint32_t childCount() const {
+			return static_cast<uint32_t>(std::popcount(nodeMap));
+		}
+
+		inline TrieNode** children() {
+			return reinterpret_cast<TrieNode**>(reinterpret_cast<char*>(this) + childOffset());
+		}
+
+		inline TrieNode* const* children() const {
+			return reinterpret_cast<TrieNode* const*>(reinterpret_cast<const char*>(this) + childOffset());
+		}
+
+		inline value_type* pairs() {
+			return std::launder(reinterpret_cast<value_type*>(reinterpret_cast<char*>(this) + pairOffset(childCount())));
+		}
+
+		inline const value_type* pairs() const {
+			return std::launder(reinterpret_cast<const value_type*>(reinterpret_cast<const char*>(this) + pairOffset(childCount())));
+		}
+
+		// a node with room for the pairs and children the maps call for, none of them constructed yet.
+		inline static TrieNode* allocate(uint32_t dataMapNew, uint32_t nodeMapNew, uint32_t collisionCountNew = 0) {
+			auto pairCount = collisionCountNew ? collisionCountNew : static_cast<uint32_t>(std::popcount(dataMapNew));
+			void* memory = ::operator new(bytesFor(pairCount, static_cast<uint32_t>(std::popcount(nodeMapNew))), alignment());
+			auto node = new (memory) TrieNode{};
+			node->dataMap = dataMapNew;
+			node->nodeMap = nodeMapNew;
+			node->collisionCount = collisionCountNew;
+			return node;
+		}
+
+		inline static void retain(TrieNode* node) {
+			node->refCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		inline static void release(TrieNode* node) {
+			if (node->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				for (uint32_t x = 0; x < node->childCount(); ++x) {
+					release(node->children()[x]);
+				}
+				destroyShell(node);
+			}
+		}
+
+		// destroys the pairs and frees the node, but leaves the children alone, for when they've been handed to another node.
+		inline static void destroyShell(TrieNode* node) {
+			auto bytes = bytesFor(node->dataCount(), node->childCount());
+			std::destroy_n(node->pairs(), node->dataCount());
+			node->~TrieNode();
+			::operator delete(static_cast<void*>(node), bytes, alignment());
+		}
+
+	  protected:
+		inline static constexpr uint64_t roundUp(uint64_t value, uint64_t alignmentNew) {
+			return (value + alignmentNew - 1) / alignmentNew * alignmentNew;
+		}
+
+		inline static constexpr uint64_t childOffset() {
+			return roundUp(sizeof(TrieNode), alignof(TrieNode*));
+		}
+
+		inline static constexpr uint64_t pairOffset(uint32_t childCountNew) {
+			return roundUp(childOffset() + childCountNew * sizeof(TrieNode*), alignof(value_type));
+		}
+
+		inline static constexpr uint64_t bytesFor(uint32_t pairCount, uint32_t childCountNew) {
+			return pairOffset(childCountNew) + pairCount * sizeof(value_type);
+		}
+
+		inline static constexpr std::align_val_t alignment() {
+			return std::align_val_t{ std::max(alignof(TrieNode), alignof(value_type)) };
+		}
+	};
+
+	// a hash array mapped trie: 32 way nodes indexed by five bits of the key's hash at a time, the hash coming from the same
+	// KeyHasher the other maps use. nodes are reference counted and never change once another map shares them, so a copy,
+	// which is what snapshot() returns, is O(1). a write copies the nodes on the path to its key, at most 14 of them, and
+	// shares the rest. while a node isn't shared, writes change it in place. a lookup reads one node per five bits of hash
+	// it needs, about log32(size()) of them. iterators and references are invalidated by any write to the map they came
+	// from, but a snapshot's stay good until the snapshot itself is written to or destroyed. emplace() and erase() report
+	// whether they changed anything rather than returning an iterator, since an iterator into a trie is a stack of nodes.
+	template<typename KeyType, typename ValueType> class PersistentMap : protected KeyHasher, protected ObjectCompare {
+	  public:
+		using mapped_type = ValueType;
+		using key_type = KeyType;
+		using value_type = Pair<key_type, mapped_type>;
+		using const_reference = const mapped_type&;
+		using size_type = uint64_t;
+		using key_hasher = KeyHasher;
+		using object_compare = ObjectCompare;
+		using node_type = TrieNode<value_type>;
+
+		inline static constexpr uint32_t bitsPerLevel{ 5 };
+		// thirteen levels of bitmaps use up the hash, and a collision node may sit below the last of them.
+		inline static constexpr uint32_t maxDepth{ 64 / bitsPerLevel + 2 };
+
+		class ConstIterator {
+		  public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = PersistentMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using reference = const value_type&;
+			using pointer = const value_type*;
+
+			inline ConstIterator() = default;
+
+			inline explicit ConstIterator(const node_type* rootNew) {
+				if (rootNew) {
+					frames[depth++] = { rootNew, 0 };
+					advance();
+				}
+			}
+
+			inline reference operator*() const {
+				return *current;
+			}
+
+			inline pointer operator->() const {
+				return current;
+			}
+
+			inline ConstIterator& operator++() {
+				advance();
+				return *this;
+			}
+
+			inline ConstIterator operator++(int32_t) {
+				auto copy = *this;
+				advance();
+				return copy;
+			}
+
+			inline bool operator==(const ConstIterator& other) const {
+				return current == other.current;
+			}
+
+		  protected:
+			friend class PersistentMap;
+
+			// a node on the way down to current, and where to carry on in it: its pairs first, then its children.
+			struct Frame {
+				const node_type* node;
+				uint32_t next;
+			};
+
+			Frame frames[maxDepth]{};
+			uint32_t depth{};
+			const value_type* current{};
+
+			inline void advance() {
+				while (depth > 0) {
+					auto& frame = frames[depth - 1];
+					auto dataCount = frame.node->dataCount();
+					if (frame.next < dataCount) {
+						current = frame.node->pairs() + frame.next++;
+						return;
+					} else if (frame.next < dataCount + frame.node->childCount()) {
+						auto child = frame.node->children()[frame.next++ - dataCount];
+						frames[depth++] = { child, 0 };
+					} else {
+						--depth;
+					}
+				}
+				current = nullptr;
+			}
+		};
+
+		using iterator = ConstIterator;
+		using const_iterator = ConstIterator;
+
+		inline PersistentMap() = default;
+
+		inline PersistentMap(const PersistentMap& other) : root{ other.root }, sizeVal{ other.sizeVal } {
+			if (root) {
+				node_type::retain(root);
+			}
+		}
+
+		inline PersistentMap(PersistentMap&& other) noexcept : root{ std::exchange(other.root, nullptr) }, sizeVal{ std::exchange(other.sizeVal, 0) } {
+		}
+
+		inline PersistentMap& operator=(PersistentMap other) noexcept {
+			swap(other);
+			return *this;
+		}
+
+		inline PersistentMap(std::initializer_list<value_type> list) {
+			for (auto& value: list) {
+				emplace(value.first, value.second);
+			}
+		}
+
+		inline ~PersistentMap() {
+			clear();
+		}
+
+		// O(1): the snapshot shares every node with this map, and neither sees the other's later writes.
+		inline PersistentMap snapshot() const {
+			return *this;
+		}
+
+		// like UnorderedMap, emplacing a key that's already present replaces its value. true when the key is new.
+		template<typename key_type_new, typename... Args> inline bool emplace(key_type_new&& key, Args&&... value) {
+			auto hash = key_hasher()(key);
+			if (!root) {
+				root = node_type::allocate(bitFor(hash, 0), 0);
+				new (root->pairs()) value_type{ std::forward<key_type_new>(key), mapped_type{ std::forward<Args>(value)... } };
+				sizeVal = 1;
+				return true;
+			}
+			bool added{};
+			bool unique = isUnique(root);
+			auto newRoot = insertInto(root, unique, hash, 0, added, std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			if (!unique) {
+				node_type::release(root);
+			}
+			root = newRoot;
+			sizeVal += added;
+			return added;
+		}
+
+		template<typename key_type_new> inline const_iterator find(const key_type_new& key) const {
+			const_iterator result{};
+			if (!root) {
+				return result;
+			}
+			auto hash = key_hasher()(key);
+			const node_type* node = root;
+			for (uint32_t shift = 0;; shift += bitsPerLevel) {
+				if (node->collisionCount) {
+					for (uint32_t x = 0; x < node->collisionCount; ++x) {
+						if (object_compare()(node->pairs()[x].first, key)) {
+							result.frames[result.depth++] = { node, x + 1 };
+							result.current = node->pairs() + x;
+							return result;
+						}
+					}
+					return const_iterator{};
+				}
+				auto bit = bitFor(hash, shift);
+				if (node->dataMap & bit) {
+					auto index = indexFor(node->dataMap, bit);
+					if (!object_compare()(node->pairs()[index].first, key)) {
+						return const_iterator{};
+					}
+					result.frames[result.depth++] = { node, index + 1 };
+					result.current = node->pairs() + index;
+					return result;
+				} else if (node->nodeMap & bit) {
+					auto index = indexFor(node->nodeMap, bit);
+					result.frames[result.depth++] = { node, node->dataCount() + index + 1 };
+					node = node->children()[index];
+				} else {
+					return const_iterator{};
+				}
+			}
+		}
+
+		template<typename key_type_new> inline const_reference at(const key_type_new& key) const {
+			auto pair = findPair(key);
+			if (!pair) {
+				throw std::out_of_range{ "Sorry, but an object by that key doesn't exist in this map." };
+			}
+			return pair->second;
+		}
+
+		template<typename key_type_new> inline bool contains(const key_type_new& key) const {
+			return findPair(key) != nullptr;
+		}
+
+		// true when the key was there to erase.
+		template<typename key_type_new> inline bool erase(const key_type_new& key) {
+			if (!findPair(key)) {
+				return false;
+			}
+			bool unique = isUnique(root);
+			auto newRoot = eraseFrom(root, unique, key_hasher()(key), 0, key);
+			if (!unique) {
+				node_type::release(root);
+			}
+			root = newRoot;
+			--sizeVal;
+			return true;
+		}
+
+		inline const_iterator begin() const {
+			return const_iterator{ root };
+		}
+
+		inline const_iterator end() const {
+			return {};
+		}
+
+		inline size_type size() const {
+			return sizeVal;
+		}
+
+		inline bool empty() const {
+			return sizeVal == 0;
+		}
+
+		inline void swap(PersistentMap& other) noexcept {
+			std::swap(root, other.root);
+			std::swap(sizeVal, other.sizeVal);
+		}
+
+		inline void clear() {
+			if (root) {
+				node_type::release(root);
+				root = nullptr;
+			}
+			sizeVal = 0;
+		}
+
+	  protected:
+		node_type* root{};
+		size_type sizeVal{};
+
+		inline static uint32_t bitFor(uint64_t hash, uint32_t shift) {
+			return uint32_t{ 1 } << ((hash >> shift) & 31);
+		}
+
+		inline static uint32_t indexFor(uint32_t map, uint32_t bit) {
+			return static_cast<uint32_t>(std::popcount(map & (bit - 1)));
+		}
+
+		// a node may be changed in place when nothing but the path being written to holds it.
+		inline static bool isUnique(const node_type* node) {
+			return node->refCount.load(std::memory_order_acquire) == 1;
+		}
+
+		template<typename key_type_new> inline const value_type* findPair(const key_type_new& key) const {
+			if (!root) {
+				return nullptr;
+			}
+			auto hash = key_hasher()(key);
+			const node_type* node = root;
+			for (uint32_t shift = 0;; shift += bitsPerLevel) {
+				if (node->collisionCount) {
+					for (uint32_t x = 0; x < node->collisionCount; ++x) {
+						if (object_compare()(node->pairs()[x].first, key)) {
+							return node->pairs() + x;
+						}
+					}
+					return nullptr;
+				}
+				auto bit = bitFor(hash, shift);
+				if (node->dataMap & bit) {
+					auto pair = node->pairs() + indexFor(node->dataMap, bit);
+					return object_compare()(pair->first, key) ? pair : nullptr;
+				} else if (node->nodeMap & bit) {
+					node = node->children()[indexFor(node->nodeMap, bit)];
+				} else {
+					return nullptr;
+				}
+			}
+		}
+
+		// a node like node, but with the maps given. the pairs and children the two have in common are moved over when node is
+		// unique, which also frees node, and copied otherwise. anything new is left for the caller to fill in.
+		inline static node_type* reshape(node_type* node, bool unique, uint32_t dataMapNew, uint32_t nodeMapNew, uint32_t collisionCountNew = 0) {
+			auto result = node_type::allocate(dataMapNew, nodeMapNew, collisionCountNew);
+			if (node->collisionCount) {
+				for (uint32_t x = 0; x < std::min(node->collisionCount, collisionCountNew); ++x) {
+					constructPair(result->pairs() + x, node->pairs()[x], unique);
+				}
+			} else {
+				for (auto shared = node->dataMap & dataMapNew; shared; shared &= shared - 1) {
+					auto bit = shared & (~shared + 1);
+					constructPair(result->pairs() + indexFor(dataMapNew, bit), node->pairs()[indexFor(node->dataMap, bit)], unique);
+				}
+				for (auto shared = node->nodeMap & nodeMapNew; shared; shared &= shared - 1) {
+					auto bit = shared & (~shared + 1);
+					auto child = node->children()[indexFor(node->nodeMap, bit)];
+					if (!unique) {
+						node_type::retain(child);
+					}
+					result->children()[indexFor(nodeMapNew, bit)] = child;
+				}
+			}
+			if (unique) {
+				node_type::destroyShell(node);
+			}
+			return result;
+		}
+
+		inline static void constructPair(value_type* target, value_type& source, bool move) {
+			if (move) {
+				new (target) value_type{ std::move(source) };
+			} else {
+				new (target) value_type{ source };
+			}
+		}
+
+		template<typename key_type_new, typename... Args> inline static void constructPair(value_type* target, key_type_new&& key, Args&&... value) {
+			new (target) value_type{ std::forward<key_type_new>(key), mapped_type{ std::forward<Args>(value)... } };
+		}
+
+		template<typename... Args> inline static node_type* replaceValue(node_type* node, bool unique, uint32_t index, Args&&... value) {
+			auto target = unique ? node : reshape(node, false, node->dataMap, node->nodeMap, node->collisionCount);
+			target->pairs()[index].second = mapped_type{ std::forward<Args>(value)... };
+			return target;
+		}
+
+		// a subtrie holding existing and the new pair, for two keys whose hashes agree below shift.
+		template<typename PairType, typename key_type_new, typename... Args>
+		inline static node_type* mergePairs(PairType&& existing, uint64_t existingHash, uint64_t hash, uint32_t shift, key_type_new&& key, Args&&... value) {
+			if (shift >= 64) {
+				auto result = node_type::allocate(0, 0, 2);
+				new (result->pairs()) value_type{ std::forward<PairType>(existing) };
+				constructPair(result->pairs() + 1, std::forward<key_type_new>(key), std::forward<Args>(value)...);
+				return result;
+			}
+			auto existingBit = bitFor(existingHash, shift);
+			auto newBit = bitFor(hash, shift);
+			if (existingBit == newBit) {
+				auto result = node_type::allocate(0, newBit);
+				result->children()[0] = mergePairs(std::forward<PairType>(existing), existingHash, hash, shift + bitsPerLevel,
+					std::forward<key_type_new>(key), std::forward<Args>(value)...);
+				return result;
+			}
+			auto result = node_type::allocate(existingBit | newBit, 0);
+			new (result->pairs() + indexFor(existingBit | newBit, existingBit)) value_type{ std::forward<PairType>(existing) };
+			constructPair(result->pairs() + indexFor(existingBit | newBit, newBit), std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			return result;
+		}
+
+		// node with the key set to the value, which is node itself when it's unique and doesn't change shape. when it isn't
+		// unique, node is left as it was, still held by whatever held it.
+		template<typename key_type_new, typename... Args>
+		inline node_type* insertInto(node_type* node, bool unique, uint64_t hash, uint32_t shift, bool& added, key_type_new&& key, Args&&... value) {
+			if (node->collisionCount) {
+				for (uint32_t x = 0; x < node->collisionCount; ++x) {
+					if (object_compare()(node->pairs()[x].first, key)) {
+						return replaceValue(node, unique, x, std::forward<Args>(value)...);
+					}
+				}
+				added = true;
+				auto count = node->collisionCount;
+				auto result = reshape(node, unique, 0, 0, count + 1);
+				constructPair(result->pairs() + count, std::forward<key_type_new>(key), std::forward<Args>(value)...);
+				return result;
+			}
+			auto bit = bitFor(hash, shift);
+			if (node->dataMap & bit) {
+				auto index = indexFor(node->dataMap, bit);
+				auto& existing = node->pairs()[index];
+				if (object_compare()(existing.first, key)) {
+					return replaceValue(node, unique, index, std::forward<Args>(value)...);
+				}
+				added = true;
+				auto existingHash = key_hasher()(existing.first);
+				auto child = unique ? mergePairs(std::move(existing), existingHash, hash, shift + bitsPerLevel, std::forward<key_type_new>(key),
+										  std::forward<Args>(value)...)
+									: mergePairs(std::as_const(existing), existingHash, hash, shift + bitsPerLevel, std::forward<key_type_new>(key),
+										  std::forward<Args>(value)...);
+				auto result = reshape(node, unique, node->dataMap & ~bit, node->nodeMap | bit);
+				result->children()[indexFor(result->nodeMap, bit)] = child;
+				return result;
+			} else if (node->nodeMap & bit) {
+				auto index = indexFor(node->nodeMap, bit);
+				auto child = node->children()[index];
+				bool childUnique = unique && isUnique(child);
+				auto newChild = insertInto(child, childUnique, hash, shift + bitsPerLevel, added, std::forward<key_type_new>(key), std::forward<Args>(value)...);
+				return replaceChild(node, unique, index, child, childUnique, newChild);
+			}
+			added = true;
+			auto result = reshape(node, unique, node->dataMap | bit, node->nodeMap);
+			constructPair(result->pairs() + indexFor(result->dataMap, bit), std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			return result;
+		}
+
+		// node with the child at index, which was child, now newChild.
+		inline static node_type* replaceChild(node_type* node, bool unique, uint32_t index, node_type* child, bool childUnique, node_type* newChild) {
+			if (unique) {
+				// node held its own reference to a shared child, which newChild now takes the place of.
+				if (!childUnique) {
+					node_type::release(child);
+				}
+				node->children()[index] = newChild;
+				return node;
+			}
+			auto result = reshape(node, false, node->dataMap, node->nodeMap);
+			node_type::release(result->children()[index]);
+			result->children()[index] = newChild;
+			return result;
+		}
+
+		// node without the key, which is known to be in it, or nullptr once nothing is left. a child that ends up with a
+		// single pair and no children of its own gets folded back into node, which keeps every path as short as it can be.
+		template<typename key_type_new> inline node_type* eraseFrom(node_type* node, bool unique, uint64_t hash, uint32_t shift, const key_type_new& key) {
+			if (node->collisionCount) {
+				auto result = node_type::allocate(0, 0, node->collisionCount - 1);
+				for (uint32_t x = 0, y = 0; x < node->collisionCount; ++x) {
+					if (!object_compare()(node->pairs()[x].first, key)) {
+						constructPair(result->pairs() + y++, node->pairs()[x], unique);
+					}
+				}
+				if (unique) {
+					node_type::destroyShell(node);
+				}
+				return result;
+			}
+			auto bit = bitFor(hash, shift);
+			if (node->dataMap & bit) {
+				if (node->dataCount() == 1 && node->childCount() == 0) {
+					if (unique) {
+						node_type::destroyShell(node);
+					}
+					return nullptr;
+				}
+				return reshape(node, unique, node->dataMap & ~bit, node->nodeMap);
+			}
+			auto index = indexFor(node->nodeMap, bit);
+			auto child = node->children()[index];
+			bool childUnique = unique && isUnique(child);
+			auto newChild = eraseFrom(child, childUnique, hash, shift + bitsPerLevel, key);
+			if (!newChild) {
+				if (unique && !childUnique) {
+					node_type::release(child);
+				}
+				return reshape(node, unique, node->dataMap, node->nodeMap & ~bit);
+			}
+			if (newChild->childCount() == 0 && newChild->dataCount() == 1) {
+				if (unique && !childUnique) {
+					node_type::release(child);
+				}
+				auto result = reshape(node, unique, node->dataMap | bit, node->nodeMap & ~bit);
+				constructPair(result->pairs() + indexFor(result->dataMap, bit), newChild->pairs()[0], true);
+				node_type::release(newChild);
+				return result;
+			}
+			return replaceChild(node, unique, index, child, childUnique, newChild);
+		}
+	};
+}
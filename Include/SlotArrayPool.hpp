@@ -0,0 +1,257 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// SlotArrayPool.hpp - Header file for the slot_array_pool, node_pool, pooled_allocator and pooled_node_allocator classes.
+/// \file SlotArrayPool.hpp
+
+#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <bit>
+#include <new>
+#include <utility>
+
+namespace detailv3 {
+
+	// a per-thread cache of freed slot arrays, keyed by size class. a hash table only ever asks for a handful of distinct
+	// sizes, so a map that gets built, used briefly and thrown away can pick up the array that its predecessor left behind
+	// instead of going back to malloc.
+	template<typename T> class slot_array_pool {
+	  public:
+		static constexpr size_t max_cached_per_class = 4;
+		static constexpr size_t max_cached_bytes = size_t(1) << 24;
+
+		static T* allocate(size_t count) {
+			if (cacheable(count) && !torn_down()) {
+				if (T* result = local().take(count)) {
+					return result;
+				}
+			}
+			return std::allocator<T>().allocate(count);
+		}
+
+		static void deallocate(T* pointer, size_t count) {
+			if (cacheable(count) && !torn_down() && local().give(pointer, count)) {
+				return;
+			}
+			std::allocator<T>().deallocate(pointer, count);
+		}
+
+		// hands every cached array on the calling thread back to the system allocator
+		static void release() {
+			if (!torn_down()) {
+				local().release_all();
+			}
+		}
+
+		~slot_array_pool() {
+			release_all();
+			torn_down() = true;
+		}
+
+	  private:
+		struct cached_array {
+			T* pointer;
+			size_t count;
+		};
+		struct size_class {
+			cached_array arrays[max_cached_per_class];
+			size_t size = 0;
+		};
+		size_class size_classes[64]{};
+
+		static slot_array_pool& local() {
+			thread_local slot_array_pool pool;
+			return pool;
+		}
+		// maps that outlive the thread's pool (thread_locals destroyed after it) go straight to the allocator
+		static bool& torn_down() {
+			thread_local bool value = false;
+			return value;
+		}
+		static bool cacheable(size_t count) {
+			return count > 0 && count <= max_cached_bytes / sizeof(T);
+		}
+		static size_t class_for(size_t count) {
+			return std::bit_width(count) - 1;
+		}
+
+		T* take(size_t count) {
+			size_class& cached = size_classes[class_for(count)];
+			for (size_t x = cached.size; x > 0; --x) {
+				if (cached.arrays[x - 1].count == count) {
+					T* result = cached.arrays[x - 1].pointer;
+					cached.arrays[x - 1] = cached.arrays[--cached.size];
+					return result;
+				}
+			}
+			return nullptr;
+		}
+		bool give(T* pointer, size_t count) {
+			size_class& cached = size_classes[class_for(count)];
+			if (cached.size == max_cached_per_class) {
+				return false;
+			}
+			cached.arrays[cached.size++] = { pointer, count };
+			return true;
+		}
+		void release_all() {
+			for (size_class& cached: size_classes) {
+				for (size_t x = 0; x < cached.size; ++x) {
+					std::allocator<T>().deallocate(cached.arrays[x].pointer, cached.arrays[x].count);
+				}
+				cached.size = 0;
+			}
+		}
+	};
+
+	// a per-thread free list of single objects, for tables that keep each element in a node of its own. erasing and
+	// inserting over and over then reuses the same few nodes instead of hitting malloc for every element
+	template<typename T> class node_pool {
+	  public:
+		static constexpr size_t max_cached_bytes = size_t(1) << 20;
+
+		static T* allocate() {
+			if (cacheable && !torn_down()) {
+				if (T* result = local().take()) {
+					return result;
+				}
+			}
+			return std::allocator<T>().allocate(1);
+		}
+
+		static void deallocate(T* pointer) {
+			if (cacheable && !torn_down() && local().give(pointer)) {
+				return;
+			}
+			std::allocator<T>().deallocate(pointer, 1);
+		}
+
+		static void release() {
+			if (!torn_down()) {
+				local().release_all();
+			}
+		}
+
+		~node_pool() {
+			release_all();
+			torn_down() = true;
+		}
+
+	  private:
+		// a free node holds the link to the next one in its own storage
+		struct free_node {
+			free_node* next;
+		};
+		static constexpr bool cacheable = sizeof(T) >= sizeof(free_node) && alignof(T) >= alignof(free_node);
+		static constexpr size_t max_cached = max_cached_bytes / sizeof(T) + 1;
+		free_node* head = nullptr;
+		size_t size = 0;
+
+		static node_pool& local() {
+			thread_local node_pool pool;
+			return pool;
+		}
+		static bool& torn_down() {
+			thread_local bool value = false;
+			return value;
+		}
+
+		T* take() {
+			if (head == nullptr) {
+				return nullptr;
+			}
+			free_node* result = std::exchange(head, head->next);
+			--size;
+			return reinterpret_cast<T*>(result);
+		}
+		bool give(T* pointer) {
+			if (size == max_cached) {
+				return false;
+			}
+			head = new (static_cast<void*>(pointer)) free_node{ head };
+			++size;
+			return true;
+		}
+		void release_all() {
+			while (head != nullptr) {
+				std::allocator<T>().deallocate(reinterpret_cast<T*>(std::exchange(head, head->next)), 1);
+			}
+			size = 0;
+		}
+	};
+}
+
+// a stateless allocator that recycles through the calling thread's slot_array_pool. memory freed on another thread just
+// lands in that thread's pool, which is fine since everything ultimately comes from std::allocator
+template<typename T> class pooled_allocator {
+  public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	pooled_allocator() noexcept = default;
+	template<typename U> pooled_allocator(const pooled_allocator<U>&) noexcept {
+	}
+
+	T* allocate(size_t count) {
+		return detailv3::slot_array_pool<T>::allocate(count);
+	}
+	void deallocate(T* pointer, size_t count) {
+		detailv3::slot_array_pool<T>::deallocate(pointer, count);
+	}
+};
+
+template<typename T, typename U> bool operator==(const pooled_allocator<T>&, const pooled_allocator<U>&) noexcept {
+	return true;
+}
+
+// single objects go through the calling thread's node_pool, anything bigger straight to std::allocator
+template<typename T> class pooled_node_allocator {
+  public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	pooled_node_allocator() noexcept = default;
+	template<typename U> pooled_node_allocator(const pooled_node_allocator<U>&) noexcept {
+	}
+
+	T* allocate(size_t count) {
+		return count == 1 ? detailv3::node_pool<T>::allocate() : std::allocator<T>().allocate(count);
+	}
+	void deallocate(T* pointer, size_t count) {
+		if (count == 1) {
+			detailv3::node_pool<T>::deallocate(pointer);
+		} else {
+			std::allocator<T>().deallocate(pointer, count);
+		}
+	}
+};
+
+template<typename T, typename U> bool operator==(const pooled_node_allocator<T>&, const pooled_node_allocator<U>&) noexcept {
+	return true;
+}
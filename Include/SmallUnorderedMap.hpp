@@ -0,0 +1,333 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// SmallUnorderedMap.hpp - Header file for the SmallUnorderedMap class.
+/// \file SmallUnorderedMap.hpp
+
+#pragma once
+
+#include <UnorderedMap.hpp>
+#include <stdexcept>
+#include <optional>
+#include <bit>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+namespace DiscordCoreAPI {
+
+	// a copy of a small map's keys, for 64 bit integer keys, laid out so that a lookup can compare four of them at a time.
+	// other key types are compared where they sit in the slots.
+	template<typename KeyType, uint64_t SmallSize, bool MirrorKeys> struct SmallMapKeys {
+		inline static constexpr bool mirrorsKeys{ false };
+
+		inline void setKey(uint64_t, const KeyType&) {
+		}
+	};
+
+	template<typename KeyType, uint64_t SmallSize> struct SmallMapKeys<KeyType, SmallSize, true> {
+		inline static constexpr bool mirrorsKeys{ true };
+		// rounded up to whole blocks of four. whatever sits past the live keys gets masked off.
+		alignas(32) uint64_t keys[(SmallSize + 3) / 4 * 4]{};
+
+		inline void setKey(uint64_t index, const KeyType& key) {
+			keys[index] = static_cast<uint64_t>(key);
+		}
+
+		// the index of key among the first count keys, or SmallSize.
+		inline uint64_t findKey(uint64_t key, uint64_t count) const {
+#if defined(__AVX2__)
+			const __m256i needle = _mm256_set1_epi64x(static_cast<int64_t>(key));
+			for (uint64_t x = 0; x < count; x += 4) {
+				const __m256i block = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + x));
+				auto mask = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle))));
+				if (mask) {
+					auto index = x + static_cast<uint64_t>(std::countr_zero(mask));
+					return index < count ? index : SmallSize;
+				}
+			}
+#else
+			for (uint64_t x = 0; x < count; ++x) {
+				if (keys[x] == key) {
+					return x;
+				}
+			}
+#endif
+			return SmallSize;
+		}
+	};
+
+	// keeps up to SmallSize entries in the map object itself and finds them by comparing keys one after another, without
+	// hashing anything or touching the heap. the entries sit in the same ObjectCore slots the hashed map uses, packed at the
+	// front and followed by an end marker, so both modes share UnorderedMap's iterator. the first insert that doesn't fit
+	// moves everything into an UnorderedMap, which the map keeps using until clear().
+	template<typename KeyType, typename ValueType, uint64_t SmallSize = 8,
+		typename AllocatorType = JsonifierInternal::AllocWrapper<ObjectCore<Pair<KeyType, ValueType>>>, template<typename> class HashPolicyType = HashPolicy>
+	class SmallUnorderedMap : protected SmallMapKeys<KeyType, SmallSize, IntegerT<KeyType> && sizeof(KeyType) == 8>, protected ObjectCompare {
+	  public:
+		static_assert(SmallSize > 0 && SmallSize <= 32, "SmallUnorderedMap is meant for maps of up to 32 entries.");
+
+		using map_type = UnorderedMap<KeyType, ValueType, AllocatorType, HashPolicyType>;
+		using mapped_type = ValueType;
+		using key_type = KeyType;
+		using reference = mapped_type&;
+		using value_type = Pair<key_type, mapped_type>;
+		using value_type_internal = ObjectCore<Pair<key_type, mapped_type>>;
+		using const_reference = const mapped_type&;
+		using size_type = uint64_t;
+		using object_compare = ObjectCompare;
+		using iterator = typename map_type::iterator;
+		using const_iterator = typename map_type::const_iterator;
+		using small_keys = SmallMapKeys<KeyType, SmallSize, IntegerT<KeyType> && sizeof(KeyType) == 8>;
+
+		inline SmallUnorderedMap() {
+			smallSlots[SmallSize].currentIndex = endValue;
+		};
+
+		inline SmallUnorderedMap& operator=(SmallUnorderedMap&& other) noexcept {
+			if (this != &other) {
+				clear();
+				if (other.largeMap) {
+					largeMap = std::move(other.largeMap);
+				} else {
+					for (size_type x = 0; x < other.smallCount; ++x) {
+						appendSmall(std::move(other.smallSlots[x].value.first), std::move(other.smallSlots[x].value.second));
+					}
+				}
+				other.clear();
+			}
+			return *this;
+		}
+
+		inline SmallUnorderedMap(SmallUnorderedMap&& other) noexcept : SmallUnorderedMap{} {
+			*this = std::move(other);
+		}
+
+		inline SmallUnorderedMap& operator=(const SmallUnorderedMap& other) {
+			if (this != &other) {
+				clear();
+				if (other.largeMap) {
+					largeMap.emplace(*other.largeMap);
+				} else {
+					for (size_type x = 0; x < other.smallCount; ++x) {
+						appendSmall(other.smallSlots[x].value.first, other.smallSlots[x].value.second);
+					}
+				}
+			}
+			return *this;
+		}
+
+		inline SmallUnorderedMap(const SmallUnorderedMap& other) : SmallUnorderedMap{} {
+			*this = other;
+		}
+
+		inline SmallUnorderedMap(std::initializer_list<value_type> list) : SmallUnorderedMap{} {
+			reserve(list.size());
+			for (auto& value: list) {
+				emplace(value.first, value.second);
+			}
+		};
+
+		// like UnorderedMap, emplacing a key that's already present replaces its value.
+		template<typename key_type_new, typename... Args> inline iterator emplace(key_type_new&& key, Args&&... value) {
+			if (largeMap) {
+				return largeMap->emplace(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			}
+			auto index = findSmall(key);
+			if (index < smallCount) {
+				smallSlots[index].value.second = mapped_type{ std::forward<Args>(value)... };
+				return iterator{ smallSlots + index };
+			} else if (smallCount < SmallSize) {
+				return appendSmall(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			}
+			promote(SmallSize * 2);
+			return largeMap->emplace(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+		}
+
+		template<typename key_type_new> inline const_iterator find(key_type_new&& key) const {
+			return const_cast<SmallUnorderedMap*>(this)->find(std::forward<key_type_new>(key));
+		}
+
+		template<typename key_type_new> inline iterator find(key_type_new&& key) {
+			if (largeMap) {
+				return largeMap->find(std::forward<key_type_new>(key));
+			}
+			auto index = findSmall(key);
+			return index < smallCount ? iterator{ smallSlots + index } : end();
+		}
+
+		template<typename key_type_new> inline reference operator[](key_type_new&& key) {
+			return emplace(std::forward<key_type_new>(key), mapped_type())->second;
+		}
+
+		template<typename key_type_new> inline const_reference at(key_type_new&& key) const {
+			return const_cast<SmallUnorderedMap*>(this)->at(std::forward<key_type_new>(key));
+		}
+
+		template<typename key_type_new> inline reference at(key_type_new&& key) {
+			auto iter = find(std::forward<key_type_new>(key));
+			if (iter == end()) {
+				throw std::out_of_range{ "Sorry, but an object by that key doesn't exist in this map." };
+			}
+			return iter->second;
+		}
+
+		template<typename key_type_new> inline bool contains(key_type_new&& key) const {
+			if (largeMap) {
+				return largeMap->contains(std::forward<key_type_new>(key));
+			}
+			return findSmall(key) < smallCount;
+		}
+
+		// the last entry moves into the hole, so the returned iterator points at the entry that now follows the erased one.
+		inline iterator erase(iterator iter) {
+			if (largeMap) {
+				return largeMap->erase(iter);
+			}
+			return eraseSmall(static_cast<size_type>(iter.getRawPtr() - smallSlots));
+		}
+
+		template<typename key_type_new> inline iterator erase(key_type_new&& key) {
+			if (largeMap) {
+				return largeMap->erase(std::forward<key_type_new>(key));
+			}
+			auto index = findSmall(key);
+			return index < smallCount ? eraseSmall(index) : end();
+		}
+
+		inline const_iterator begin() const {
+			return largeMap ? static_cast<const map_type&>(*largeMap).begin() : const_iterator{ const_cast<value_type_internal*>(smallSlots) };
+		}
+
+		// while small this is the end marker itself, so a find() that misses can be compared against end() from either side.
+		inline const_iterator end() const {
+			return largeMap ? const_iterator{} : const_iterator{ const_cast<value_type_internal*>(smallSlots + SmallSize) };
+		}
+
+		inline iterator begin() {
+			return largeMap ? largeMap->begin() : iterator{ smallSlots };
+		}
+
+		inline iterator end() {
+			return largeMap ? iterator{} : iterator{ smallSlots + SmallSize };
+		}
+
+		inline size_type size() const {
+			return largeMap ? largeMap->size() : smallCount;
+		}
+
+		inline bool empty() const {
+			return size() == 0;
+		}
+
+		inline size_type capacity() const {
+			return largeMap ? largeMap->capacity() : SmallSize;
+		}
+
+		// whether the entries are still in the map object rather than in a hashed table.
+		inline bool is_small() const {
+			return !largeMap;
+		}
+
+		// asking for more than SmallSize entries moves to the hashed table straight away.
+		inline void reserve(size_type sizeNew) {
+			if (largeMap) {
+				largeMap->reserve(sizeNew);
+			} else if (sizeNew > SmallSize) {
+				promote(sizeNew);
+			}
+		}
+
+		// also goes back to keeping the entries inline.
+		inline void clear() {
+			largeMap.reset();
+			for (size_type x = 0; x < smallCount; ++x) {
+				smallSlots[x].disable();
+			}
+			smallCount = 0;
+		}
+
+		inline bool operator==(const SmallUnorderedMap& other) const {
+			if (size() != other.size()) {
+				return false;
+			}
+			for (const auto& [key, value]: *this) {
+				auto iter = other.find(key);
+				if (iter == other.end() || !object_compare()(iter->second, value)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+	  protected:
+		value_type_internal smallSlots[SmallSize + 1]{};
+		size_type smallCount{};
+		std::optional<map_type> largeMap{};
+
+		inline static constexpr int8_t endValue{ -1 };
+
+		template<typename key_type_new> inline size_type findSmall(const key_type_new& key) const {
+			if constexpr (small_keys::mirrorsKeys && IntegerT<key_type_new>) {
+				return this->findKey(static_cast<uint64_t>(key), smallCount);
+			} else {
+				for (size_type x = 0; x < smallCount; ++x) {
+					if (object_compare()(smallSlots[x].value.first, key)) {
+						return x;
+					}
+				}
+				return SmallSize;
+			}
+		}
+
+		template<typename key_type_new, typename... Args> inline iterator appendSmall(key_type_new&& key, Args&&... value) {
+			auto entry = smallSlots + smallCount;
+			entry->enable(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			this->setKey(smallCount++, entry->value.first);
+			return iterator{ entry };
+		}
+
+		inline iterator eraseSmall(size_type index) {
+			auto last = smallCount - 1;
+			if (index != last) {
+				smallSlots[index].enable(std::move(smallSlots[last].value.first), std::move(smallSlots[last].value.second));
+				this->setKey(index, smallSlots[index].value.first);
+			}
+			smallSlots[last].disable();
+			--smallCount;
+			return iterator{ smallSlots + index };
+		}
+
+		inline void promote(size_type capacityNew) {
+			largeMap.emplace(capacityNew);
+			for (size_type x = 0; x < smallCount; ++x) {
+				largeMap->emplace(std::move(smallSlots[x].value.first), std::move(smallSlots[x].value.second));
+				smallSlots[x].disable();
+			}
+			smallCount = 0;
+		}
+	};
+}
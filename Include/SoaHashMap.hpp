@@ -0,0 +1,498 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// SoaHashMap.hpp - Header file for the soa_flat_hash_map class.
+/// \file SoaHashMap.hpp
+
+#pragma once
+#include <SplitHashMap.hpp>
+#include <stdexcept>
+
+// split_flat_hash_map taken one step further: the metadata, the keys and the values are three arrays that share a slot
+// index. a probe reads metadata and keys and never pulls a value into cache until it has found its key, and a pass
+// over the values alone, like sum_values(), reads nothing else. dereferencing an iterator gives a
+// std::pair<const K&, V&> rather than a reference to a stored pair, so write for (auto [key, value]: map) rather than
+// for (auto& [key, value]: map).
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>>
+class soa_flat_hash_map : private H, private E {
+	using Metadata = detailv3::split_metadata;
+	using MetadataAlloc = typename std::allocator_traits<A>::template rebind_alloc<Metadata>;
+	using KeyAlloc = typename std::allocator_traits<A>::template rebind_alloc<K>;
+	using ValueAlloc = typename std::allocator_traits<A>::template rebind_alloc<V>;
+	using MetadataTraits = std::allocator_traits<MetadataAlloc>;
+	using KeyTraits = std::allocator_traits<KeyAlloc>;
+	using ValueTraits = std::allocator_traits<ValueAlloc>;
+	// arithmetic values are left at zero in empty slots, so sum_values() can add up the whole array without checking
+	// which slots are live
+	static constexpr bool zero_empty_values = std::is_arithmetic_v<V>;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+
+	template<typename ValueType> struct templated_iterator : private detailv3::split_scan_cursor {
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<K, std::remove_const_t<ValueType>>;
+		using difference_type = ptrdiff_t;
+		using reference = std::pair<const K&, ValueType&>;
+		struct pointer {
+			reference pair;
+			const reference* operator->() const {
+				return &pair;
+			}
+		};
+
+		templated_iterator() = default;
+		// starts at the first live slot at or after position. key and value are the slots that go with position
+		templated_iterator(Metadata* position, const K* key, ValueType* value) : current(this->locate(position)), key(key), value(value) {
+			if (key) {
+				this->key += current - position;
+				this->value += current - position;
+			}
+		}
+		Metadata* current = nullptr;
+		const K* key = nullptr;
+		ValueType* value = nullptr;
+
+		friend bool operator==(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return lhs.current == rhs.current;
+		}
+		friend bool operator!=(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return !(lhs == rhs);
+		}
+
+		templated_iterator& operator++() {
+			Metadata* next = this->next(current);
+			key += next - current;
+			value += next - current;
+			current = next;
+			return *this;
+		}
+		templated_iterator operator++(int32_t) {
+			templated_iterator copy(*this);
+			++*this;
+			return copy;
+		}
+
+		reference operator*() const {
+			return { *key, *value };
+		}
+		pointer operator->() const {
+			return { **this };
+		}
+
+		operator templated_iterator<const V>() const {
+			return { current, key, value };
+		}
+	};
+	using iterator = templated_iterator<V>;
+	using const_iterator = templated_iterator<const V>;
+
+	soa_flat_hash_map() {
+	}
+	explicit soa_flat_hash_map(size_type bucket_count, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+		: H(hash), E(equal), metadata_alloc(alloc), key_alloc(alloc), value_alloc(alloc) {
+		rehash(bucket_count);
+	}
+	soa_flat_hash_map(std::initializer_list<value_type> il) {
+		reserve(il.size());
+		for (auto& value: il)
+			insert(value);
+	}
+	soa_flat_hash_map(const soa_flat_hash_map& other)
+		: H(other), E(other), metadata_alloc(MetadataTraits::select_on_container_copy_construction(other.metadata_alloc)),
+		  key_alloc(KeyTraits::select_on_container_copy_construction(other.key_alloc)),
+		  value_alloc(ValueTraits::select_on_container_copy_construction(other.value_alloc)), _max_load_factor(other._max_load_factor) {
+		rehash(std::min(num_buckets_for_reserve(other.size()), other.bucket_count()));
+		for (auto [key, value]: other)
+			emplace(key, value);
+	}
+	soa_flat_hash_map(soa_flat_hash_map&& other) noexcept
+		: H(std::move(other)), E(std::move(other)), metadata_alloc(std::move(other.metadata_alloc)), key_alloc(std::move(other.key_alloc)),
+		  value_alloc(std::move(other.value_alloc)) {
+		swap_pointers(other);
+	}
+	soa_flat_hash_map& operator=(soa_flat_hash_map other) {
+		static_cast<H&>(*this) = std::move(static_cast<H&>(other));
+		static_cast<E&>(*this) = std::move(static_cast<E&>(other));
+		swap_pointers(other);
+		return *this;
+	}
+	~soa_flat_hash_map() {
+		clear();
+		deallocate_data(metadata, keys, values, num_slots_minus_one, max_lookups);
+	}
+
+	iterator begin() {
+		return { metadata, key_for(metadata), value_for(metadata) };
+	}
+	const_iterator begin() const {
+		return const_cast<soa_flat_hash_map*>(this)->begin();
+	}
+	iterator end() {
+		Metadata* end_item = metadata + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups);
+		return { end_item, key_for(end_item), value_for(end_item) };
+	}
+	const_iterator end() const {
+		return const_cast<soa_flat_hash_map*>(this)->end();
+	}
+
+	iterator find(const K& key) {
+		size_t hash = hash_object(key);
+		uint8_t fragment = fragment_for_hash(hash);
+		size_t index = hash_policy.index_for_hash(hash, num_slots_minus_one);
+		Metadata* it = metadata + ptrdiff_t(index);
+		for (int8_t distance = 0; it->distance_from_desired >= distance; ++distance, ++it) {
+			if (it->hash_fragment == fragment && compares_equal(key, keys[it - metadata]))
+				return { it, keys + (it - metadata), values + (it - metadata) };
+		}
+		return end();
+	}
+	const_iterator find(const K& key) const {
+		return const_cast<soa_flat_hash_map*>(this)->find(key);
+	}
+	size_t count(const K& key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+	bool contains(const K& key) const {
+		return count(key) != 0;
+	}
+
+	template<typename Key, typename... Args> std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+		size_t hash = hash_object(key);
+		uint8_t fragment = fragment_for_hash(hash);
+		Metadata* current_entry = metadata + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		int8_t distance_from_desired = 0;
+		for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+			if (current_entry->hash_fragment == fragment && compares_equal(key, keys[current_entry - metadata]))
+				return { iterator_at(current_entry), false };
+		}
+		if (num_slots_minus_one == 0 || distance_from_desired == max_lookups || num_elements + 1 > (num_slots_minus_one + 1) * static_cast<double>(_max_load_factor)) {
+			grow();
+			return emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+		}
+		return { place_new(hash, K(std::forward<Key>(key)), V(std::forward<Args>(args)...)), true };
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value.first, value.second);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value.first), std::move(value.second));
+	}
+	V& operator[](const K& key) {
+		return emplace(key).first->second;
+	}
+	V& operator[](K&& key) {
+		return emplace(std::move(key)).first->second;
+	}
+	V& at(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+	const V& at(const K& key) const {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	void erase(const_iterator to_erase) {
+		Metadata* current = to_erase.current;
+		destroy_slot(current);
+		--num_elements;
+		for (Metadata* next = current + ptrdiff_t(1); !next->is_at_desired_position(); ++current, ++next) {
+			construct_slot(current, next->distance_from_desired - 1, next->hash_fragment, std::move(keys[next - metadata]), std::move(values[next - metadata]));
+			destroy_slot(next);
+		}
+	}
+	size_t erase(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			return 0;
+		erase(found);
+		return 1;
+	}
+
+	void clear() {
+		for (Metadata* it = metadata, *end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
+			if (it->has_value())
+				destroy_slot(it);
+		}
+		num_elements = 0;
+	}
+
+	void rehash(size_t num_buckets) {
+		num_buckets = std::max(num_buckets, static_cast<size_t>(std::ceil(num_elements / static_cast<double>(_max_load_factor))));
+		if (num_buckets == 0) {
+			return;
+		}
+		auto new_prime_index = hash_policy.next_size_over(num_buckets);
+		if (num_buckets == bucket_count())
+			return;
+		int8_t new_max_lookups = std::max(detailv3::min_lookups, detailv3::log2(num_buckets));
+		size_t num_slots = num_buckets + static_cast<size_t>(new_max_lookups);
+		Metadata* new_metadata = MetadataTraits::allocate(metadata_alloc, num_slots + Metadata::scan_padding);
+		K* new_keys = KeyTraits::allocate(key_alloc, num_slots);
+		V* new_values = ValueTraits::allocate(value_alloc, num_slots);
+		Metadata* special_end_item = new_metadata + static_cast<ptrdiff_t>(num_slots - 1);
+		std::uninitialized_fill_n(new_metadata, num_slots + Metadata::scan_padding, Metadata{});
+		*special_end_item = Metadata{ Metadata::special_end_value, 0 };
+		if constexpr (zero_empty_values) {
+			std::uninitialized_fill_n(new_values, num_slots, V{});
+		}
+		std::swap(metadata, new_metadata);
+		std::swap(keys, new_keys);
+		std::swap(values, new_values);
+		std::swap(num_slots_minus_one, num_buckets);
+		--num_slots_minus_one;
+		hash_policy.commit(new_prime_index);
+		int8_t old_max_lookups = max_lookups;
+		max_lookups = new_max_lookups;
+		num_elements = 0;
+		for (ptrdiff_t x = 0, end = static_cast<ptrdiff_t>(num_buckets + old_max_lookups); x != end; ++x) {
+			if (new_metadata[x].has_value()) {
+				place_new(hash_object(new_keys[x]), std::move(new_keys[x]), std::move(new_values[x]));
+				KeyTraits::destroy(key_alloc, new_keys + x);
+				ValueTraits::destroy(value_alloc, new_values + x);
+			}
+		}
+		deallocate_data(new_metadata, new_keys, new_values, num_buckets, old_max_lookups);
+	}
+	void reserve(size_t num_elements) {
+		size_t required_buckets = num_buckets_for_reserve(num_elements);
+		if (required_buckets > bucket_count())
+			rehash(required_buckets);
+	}
+
+	void swap(soa_flat_hash_map& other) {
+		using std::swap;
+		swap(static_cast<H&>(*this), static_cast<H&>(other));
+		swap(static_cast<E&>(*this), static_cast<E&>(other));
+		swap_pointers(other);
+	}
+
+	// calls f with every value, in slot order, without reading any keys
+	template<typename F> void for_each_value(F&& f) const {
+		if (!values)
+			return;
+		detailv3::split_scan_cursor cursor;
+		Metadata* end_item = metadata + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups);
+		for (Metadata* it = cursor.locate(metadata); it != end_item; it = cursor.next(it))
+			f(static_cast<const V&>(values[it - metadata]));
+	}
+	// the sum of proj(value) over every element, reading only the value array and, unless the values are plain
+	// arithmetic ones summed as they are, the metadata. in that case empty slots hold zero and the whole array is
+	// added up in four independent running sums with no branches, which the compiler can vectorize. floating point
+	// sums therefore come out in a different order than an element by element loop would add them
+	template<typename Projection = std::identity> auto sum_values(Projection proj = {}) const {
+		using Result = decltype(std::invoke(proj, std::declval<const V&>()) + std::invoke(proj, std::declval<const V&>()));
+		if constexpr (zero_empty_values && std::is_same_v<Projection, std::identity>) {
+			Result partial[4]{};
+			size_t count = values ? num_slots_minus_one + max_lookups : 0;
+			size_t x = 0;
+			for (; x + 4 <= count; x += 4) {
+				partial[0] += values[x];
+				partial[1] += values[x + 1];
+				partial[2] += values[x + 2];
+				partial[3] += values[x + 3];
+			}
+			for (; x < count; ++x) {
+				partial[0] += values[x];
+			}
+			return static_cast<Result>((partial[0] + partial[1]) + (partial[2] + partial[3]));
+		} else {
+			Result total{};
+			for_each_value([&](const V& value) {
+				total += std::invoke(proj, value);
+			});
+			return total;
+		}
+	}
+
+	size_t size() const {
+		return num_elements;
+	}
+	bool empty() const {
+		return num_elements == 0;
+	}
+	size_t bucket_count() const {
+		return num_slots_minus_one ? num_slots_minus_one + 1 : 0;
+	}
+	float load_factor() const {
+		size_t buckets = bucket_count();
+		return buckets ? static_cast<float>(num_elements) / buckets : 0;
+	}
+	void max_load_factor(float value) {
+		_max_load_factor = value;
+	}
+	float max_load_factor() const {
+		return _max_load_factor;
+	}
+	// bytes held by the metadata, key and value arrays
+	size_t memory_usage() const {
+		return num_slots_minus_one
+			? (num_slots_minus_one + max_lookups + 1) * (sizeof(Metadata) + sizeof(K) + sizeof(V)) + Metadata::scan_padding * sizeof(Metadata)
+			: 0;
+	}
+
+  private:
+	Metadata* metadata = Metadata::empty_default_table();
+	K* keys = nullptr;
+	V* values = nullptr;
+	size_t num_slots_minus_one = 0;
+	typename detailv3::HashPolicySelector<H>::type hash_policy;
+	int8_t max_lookups = detailv3::min_lookups - 1;
+	float _max_load_factor = 0.5f;
+	size_t num_elements = 0;
+	MetadataAlloc metadata_alloc;
+	KeyAlloc key_alloc;
+	ValueAlloc value_alloc;
+
+	size_t num_buckets_for_reserve(size_t num_elements) const {
+		return static_cast<size_t>(std::ceil(num_elements / std::min(0.5, static_cast<double>(_max_load_factor))));
+	}
+
+	void swap_pointers(soa_flat_hash_map& other) {
+		using std::swap;
+		swap(hash_policy, other.hash_policy);
+		swap(metadata, other.metadata);
+		swap(keys, other.keys);
+		swap(values, other.values);
+		swap(num_slots_minus_one, other.num_slots_minus_one);
+		swap(num_elements, other.num_elements);
+		swap(max_lookups, other.max_lookups);
+		swap(_max_load_factor, other._max_load_factor);
+	}
+
+	// places a key that is known not to be in the table yet, robin hood style
+	iterator place_new(size_t hash, K&& key, V&& value) {
+		uint8_t fragment = fragment_for_hash(hash);
+		Metadata* current_entry = metadata + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		int8_t distance_from_desired = 0;
+		for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+		}
+		if (distance_from_desired == max_lookups) {
+			grow();
+			return place_new(hash, std::move(key), std::move(value));
+		} else if (current_entry->is_empty()) {
+			construct_slot(current_entry, distance_from_desired, fragment, std::move(key), std::move(value));
+			++num_elements;
+			return iterator_at(current_entry);
+		}
+		K key_to_insert(std::move(key));
+		V value_to_insert(std::move(value));
+		swap_into(current_entry, distance_from_desired, fragment, key_to_insert, value_to_insert);
+		Metadata* result = current_entry;
+		for (++distance_from_desired, ++current_entry;; ++current_entry) {
+			if (current_entry->is_empty()) {
+				construct_slot(current_entry, distance_from_desired, fragment, std::move(key_to_insert), std::move(value_to_insert));
+				++num_elements;
+				return iterator_at(result);
+			} else if (current_entry->distance_from_desired < distance_from_desired) {
+				swap_into(current_entry, distance_from_desired, fragment, key_to_insert, value_to_insert);
+				++distance_from_desired;
+			} else {
+				++distance_from_desired;
+				if (distance_from_desired == max_lookups) {
+					// hand the displaced element back to the new one's slot, then grow and place the new one again
+					swap_into(result, distance_from_desired, fragment, key_to_insert, value_to_insert);
+					grow();
+					size_t new_hash = hash_object(key_to_insert);
+					return place_new(new_hash, std::move(key_to_insert), std::move(value_to_insert));
+				}
+			}
+		}
+	}
+
+	iterator iterator_at(Metadata* entry) {
+		return { entry, keys + (entry - metadata), values + (entry - metadata) };
+	}
+	// the shared empty table has no key or value arrays to point into
+	K* key_for(Metadata* entry) const {
+		return keys ? keys + (entry - metadata) : nullptr;
+	}
+	V* value_for(Metadata* entry) const {
+		return values ? values + (entry - metadata) : nullptr;
+	}
+
+	void swap_into(Metadata* entry, int8_t& distance_from_desired, uint8_t& fragment, K& key, V& value) {
+		using std::swap;
+		swap(distance_from_desired, entry->distance_from_desired);
+		swap(fragment, entry->hash_fragment);
+		swap(key, keys[entry - metadata]);
+		swap(value, values[entry - metadata]);
+	}
+
+	void construct_slot(Metadata* entry, int8_t distance_from_desired, uint8_t fragment, K&& key, V&& value) {
+		KeyTraits::construct(key_alloc, keys + (entry - metadata), std::move(key));
+		ValueTraits::construct(value_alloc, values + (entry - metadata), std::move(value));
+		entry->distance_from_desired = distance_from_desired;
+		entry->hash_fragment = fragment;
+	}
+	void destroy_slot(Metadata* entry) {
+		KeyTraits::destroy(key_alloc, keys + (entry - metadata));
+		if constexpr (zero_empty_values) {
+			values[entry - metadata] = V{};
+		} else {
+			ValueTraits::destroy(value_alloc, values + (entry - metadata));
+		}
+		entry->distance_from_desired = -1;
+	}
+
+	void grow() {
+		rehash(std::max(size_t(4), 2 * bucket_count()));
+	}
+
+	void deallocate_data(Metadata* metadata_begin, K* keys_begin, V* values_begin, size_t num_slots_minus_one, int8_t max_lookups) {
+		if (metadata_begin != Metadata::empty_default_table()) {
+			MetadataTraits::deallocate(metadata_alloc, metadata_begin, num_slots_minus_one + max_lookups + 1 + Metadata::scan_padding);
+			KeyTraits::deallocate(key_alloc, keys_begin, num_slots_minus_one + max_lookups + 1);
+			ValueTraits::deallocate(value_alloc, values_begin, num_slots_minus_one + max_lookups + 1);
+		}
+	}
+
+	// same fragment as split_flat_hash_map's
+	static uint8_t fragment_for_hash(size_t hash) {
+		return static_cast<uint8_t>(hash ^ (hash >> 56));
+	}
+	template<typename U> size_t hash_object(const U& key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	template<typename L, typename R> bool compares_equal(const L& lhs, const R& rhs) const {
+		return static_cast<const E&>(*this)(lhs, rhs);
+	}
+};
+
+// whether a K, V map is better off in soa_flat_hash_map than in split_flat_hash_map: once the values are bigger than the
+// keys, keeping them out of the way of probes pays for the extra array. the two don't dereference to the same type, see
+// soa_flat_hash_map, so code that picks one with this has to be written for whichever it gets
+template<typename K, typename V> struct prefers_soa_layout : std::bool_constant<(sizeof(V) > sizeof(K))> {};
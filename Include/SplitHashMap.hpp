@@ -0,0 +1,479 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// SplitHashMap.hpp - Header file for the split_flat_hash_map class.
+/// \file SplitHashMap.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <stdexcept>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace detailv3 {
+	// one byte of probe distance and one byte of the key's hash. these sit in their own dense array, so a probe reads
+	// 32 slots' worth of metadata per cache line and only goes to the value array once the hash byte matches.
+	struct split_metadata {
+		bool has_value() const {
+			return distance_from_desired >= 0;
+		}
+		bool is_empty() const {
+			return distance_from_desired < 0;
+		}
+		bool is_at_desired_position() const {
+			return distance_from_desired <= 0;
+		}
+		static split_metadata* empty_default_table() {
+			static split_metadata result[min_lookups + scan_padding] = { {}, {}, {}, { special_end_value, 0 } };
+			return result;
+		}
+
+		int8_t distance_from_desired = -1;
+		uint8_t hash_fragment = 0;
+		static constexpr int8_t special_end_value = 0;
+		// slots allocated past the end marker so that a 16 slot scan starting at any slot stays inside the array
+		static constexpr size_t scan_padding = 15;
+	};
+
+	// how split_flat_hash_map's iterators find live slots. locate() returns the first slot at or after current that holds
+	// a value, or the end marker, and next() the one after that. with avx2 the distance bytes of 16 slots come in with one
+	// load and their sign bits, which are set on empty slots, give a mask of the live ones. the cursor keeps the rest of
+	// that mask, so stepping to the next live slot is clearing its lowest bit rather than another load
+	struct split_scan_cursor {
+#if defined(__AVX2__)
+		split_metadata* locate(split_metadata* current) {
+			block = current;
+			bits = live_mask(block);
+			return live();
+		}
+		split_metadata* next(split_metadata*) {
+			bits &= bits - 1;
+			return live();
+		}
+
+	  private:
+		static uint32_t live_mask(const split_metadata* first) {
+			__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+			return ~static_cast<uint32_t>(_mm256_movemask_epi8(bytes)) & 0x55555555u;
+		}
+		split_metadata* live() {
+			while (bits == 0) {
+				block += 16;
+				bits = live_mask(block);
+			}
+			return block + std::countr_zero(bits) / 2;
+		}
+
+		split_metadata* block = nullptr;
+		uint32_t bits = 0;
+#else
+		split_metadata* locate(split_metadata* current) {
+			while (current->is_empty())
+				++current;
+			return current;
+		}
+		split_metadata* next(split_metadata* current) {
+			return locate(current + 1);
+		}
+#endif
+	};
+}
+
+// a robin hood table with the same probing rules as flat_hash_map, but the metadata and the key/value pairs live in two
+// separate arrays. a slot doesn't pay for the padding that puts the distance byte in front of an 8 byte aligned value,
+// and misses are decided from the metadata alone.
+template<typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>, typename A = std::allocator<std::pair<K, V>>>
+class split_flat_hash_map : private H, private E {
+	using Metadata = detailv3::split_metadata;
+	using MetadataAlloc = typename std::allocator_traits<A>::template rebind_alloc<Metadata>;
+	using ValueAlloc = typename std::allocator_traits<A>::template rebind_alloc<std::pair<K, V>>;
+	using MetadataTraits = std::allocator_traits<MetadataAlloc>;
+	using ValueTraits = std::allocator_traits<ValueAlloc>;
+
+  public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K, V>;
+	using size_type = size_t;
+	using hasher = H;
+	using key_equal = E;
+	using allocator_type = A;
+
+	template<typename ValueType> struct templated_iterator : private detailv3::split_scan_cursor {
+		templated_iterator() = default;
+		// starts at the first live slot at or after position. value is the value slot that goes with position
+		templated_iterator(Metadata* position, ValueType* value) : current(this->locate(position)), value(value) {
+			if (value)
+				this->value += current - position;
+		}
+		Metadata* current = nullptr;
+		ValueType* value = nullptr;
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ValueType;
+		using difference_type = ptrdiff_t;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+
+		friend bool operator==(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return lhs.current == rhs.current;
+		}
+		friend bool operator!=(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return !(lhs == rhs);
+		}
+
+		templated_iterator& operator++() {
+			Metadata* next = this->next(current);
+			value += next - current;
+			current = next;
+			return *this;
+		}
+		templated_iterator operator++(int32_t) {
+			templated_iterator copy(*this);
+			++*this;
+			return copy;
+		}
+
+		reference operator*() const {
+			return *value;
+		}
+		pointer operator->() const {
+			return value;
+		}
+
+		operator templated_iterator<const typename split_flat_hash_map::value_type>() const {
+			return { current, value };
+		}
+	};
+	using iterator = templated_iterator<value_type>;
+	using const_iterator = templated_iterator<const value_type>;
+
+	split_flat_hash_map() {
+	}
+	explicit split_flat_hash_map(size_type bucket_count, const H& hash = H(), const E& equal = E(), const A& alloc = A())
+		: H(hash), E(equal), metadata_alloc(alloc), value_alloc(alloc) {
+		rehash(bucket_count);
+	}
+	split_flat_hash_map(std::initializer_list<value_type> il) {
+		reserve(il.size());
+		for (auto& value: il)
+			insert(value);
+	}
+	split_flat_hash_map(const split_flat_hash_map& other)
+		: H(other), E(other), metadata_alloc(MetadataTraits::select_on_container_copy_construction(other.metadata_alloc)),
+		  value_alloc(ValueTraits::select_on_container_copy_construction(other.value_alloc)), _max_load_factor(other._max_load_factor) {
+		rehash(std::min(num_buckets_for_reserve(other.size()), other.bucket_count()));
+		for (const value_type& value: other)
+			insert(value);
+	}
+	split_flat_hash_map(split_flat_hash_map&& other) noexcept
+		: H(std::move(other)), E(std::move(other)), metadata_alloc(std::move(other.metadata_alloc)), value_alloc(std::move(other.value_alloc)) {
+		swap_pointers(other);
+	}
+	split_flat_hash_map& operator=(split_flat_hash_map other) {
+		static_cast<H&>(*this) = std::move(static_cast<H&>(other));
+		static_cast<E&>(*this) = std::move(static_cast<E&>(other));
+		swap_pointers(other);
+		return *this;
+	}
+	~split_flat_hash_map() {
+		clear();
+		deallocate_data(metadata, values, num_slots_minus_one, max_lookups);
+	}
+
+	iterator begin() {
+		return { metadata, value_for(metadata) };
+	}
+	const_iterator begin() const {
+		return const_cast<split_flat_hash_map*>(this)->begin();
+	}
+	iterator end() {
+		Metadata* end_item = metadata + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups);
+		return { end_item, value_for(end_item) };
+	}
+	const_iterator end() const {
+		return const_cast<split_flat_hash_map*>(this)->end();
+	}
+
+	iterator find(const K& key) {
+		size_t hash = hash_object(key);
+		uint8_t fragment = fragment_for_hash(hash);
+		size_t index = hash_policy.index_for_hash(hash, num_slots_minus_one);
+		Metadata* it = metadata + ptrdiff_t(index);
+		for (int8_t distance = 0; it->distance_from_desired >= distance; ++distance, ++it) {
+			if (it->hash_fragment == fragment && compares_equal(key, values[it - metadata].first))
+				return { it, values + (it - metadata) };
+		}
+		return end();
+	}
+	const_iterator find(const K& key) const {
+		return const_cast<split_flat_hash_map*>(this)->find(key);
+	}
+	size_t count(const K& key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+
+	template<typename Key, typename... Args> std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+		size_t hash = hash_object(key);
+		uint8_t fragment = fragment_for_hash(hash);
+		Metadata* current_entry = metadata + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		int8_t distance_from_desired = 0;
+		for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+			if (current_entry->hash_fragment == fragment && compares_equal(key, values[current_entry - metadata].first))
+				return { { current_entry, values + (current_entry - metadata) }, false };
+		}
+		if (num_slots_minus_one == 0 || distance_from_desired == max_lookups || num_elements + 1 > (num_slots_minus_one + 1) * static_cast<double>(_max_load_factor)) {
+			grow();
+			return emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+		}
+		return { place_new(hash, std::forward<Key>(key), std::forward<Args>(args)...), true };
+	}
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return emplace(value.first, value.second);
+	}
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return emplace(std::move(value.first), std::move(value.second));
+	}
+	V& operator[](const K& key) {
+		return emplace(key, V()).first->second;
+	}
+	V& operator[](K&& key) {
+		return emplace(std::move(key), V()).first->second;
+	}
+	V& at(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+	const V& at(const K& key) const {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	void erase(const_iterator to_erase) {
+		Metadata* current = to_erase.current;
+		destroy_slot(current);
+		--num_elements;
+		for (Metadata* next = current + ptrdiff_t(1); !next->is_at_desired_position(); ++current, ++next) {
+			construct_slot(current, next->distance_from_desired - 1, next->hash_fragment, std::move(values[next - metadata]));
+			destroy_slot(next);
+		}
+	}
+	size_t erase(const K& key) {
+		auto found = find(key);
+		if (found == end())
+			return 0;
+		erase(found);
+		return 1;
+	}
+
+	void clear() {
+		for (Metadata* it = metadata, *end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
+			if (it->has_value())
+				destroy_slot(it);
+		}
+		num_elements = 0;
+	}
+
+	void rehash(size_t num_buckets) {
+		num_buckets = std::max(num_buckets, static_cast<size_t>(std::ceil(num_elements / static_cast<double>(_max_load_factor))));
+		if (num_buckets == 0) {
+			return;
+		}
+		auto new_prime_index = hash_policy.next_size_over(num_buckets);
+		if (num_buckets == bucket_count())
+			return;
+		int8_t new_max_lookups = std::max(detailv3::min_lookups, detailv3::log2(num_buckets));
+		Metadata* new_metadata = MetadataTraits::allocate(metadata_alloc, num_buckets + new_max_lookups + Metadata::scan_padding);
+		value_type* new_values = ValueTraits::allocate(value_alloc, num_buckets + new_max_lookups);
+		Metadata* special_end_item = new_metadata + static_cast<ptrdiff_t>(num_buckets + new_max_lookups - 1);
+		std::uninitialized_fill_n(new_metadata, num_buckets + new_max_lookups + Metadata::scan_padding, Metadata{});
+		*special_end_item = Metadata{ Metadata::special_end_value, 0 };
+		std::swap(metadata, new_metadata);
+		std::swap(values, new_values);
+		std::swap(num_slots_minus_one, num_buckets);
+		--num_slots_minus_one;
+		hash_policy.commit(new_prime_index);
+		int8_t old_max_lookups = max_lookups;
+		max_lookups = new_max_lookups;
+		num_elements = 0;
+		for (ptrdiff_t x = 0, end = static_cast<ptrdiff_t>(num_buckets + old_max_lookups); x != end; ++x) {
+			if (new_metadata[x].has_value()) {
+				place_new(hash_object(new_values[x].first), std::move(new_values[x]));
+				ValueTraits::destroy(value_alloc, new_values + x);
+			}
+		}
+		deallocate_data(new_metadata, new_values, num_buckets, old_max_lookups);
+	}
+	void reserve(size_t num_elements) {
+		size_t required_buckets = num_buckets_for_reserve(num_elements);
+		if (required_buckets > bucket_count())
+			rehash(required_buckets);
+	}
+
+	void swap(split_flat_hash_map& other) {
+		using std::swap;
+		swap(static_cast<H&>(*this), static_cast<H&>(other));
+		swap(static_cast<E&>(*this), static_cast<E&>(other));
+		swap_pointers(other);
+	}
+
+	size_t size() const {
+		return num_elements;
+	}
+	bool empty() const {
+		return num_elements == 0;
+	}
+	size_t bucket_count() const {
+		return num_slots_minus_one ? num_slots_minus_one + 1 : 0;
+	}
+	float load_factor() const {
+		size_t buckets = bucket_count();
+		return buckets ? static_cast<float>(num_elements) / buckets : 0;
+	}
+	void max_load_factor(float value) {
+		_max_load_factor = value;
+	}
+	float max_load_factor() const {
+		return _max_load_factor;
+	}
+	// bytes held by the metadata and value arrays
+	size_t memory_usage() const {
+		return num_slots_minus_one ? (num_slots_minus_one + max_lookups + 1) * (sizeof(Metadata) + sizeof(value_type)) + Metadata::scan_padding * sizeof(Metadata) : 0;
+	}
+
+  private:
+	Metadata* metadata = Metadata::empty_default_table();
+	value_type* values = nullptr;
+	size_t num_slots_minus_one = 0;
+	typename detailv3::HashPolicySelector<H>::type hash_policy;
+	int8_t max_lookups = detailv3::min_lookups - 1;
+	float _max_load_factor = 0.5f;
+	size_t num_elements = 0;
+	MetadataAlloc metadata_alloc;
+	ValueAlloc value_alloc;
+
+	size_t num_buckets_for_reserve(size_t num_elements) const {
+		return static_cast<size_t>(std::ceil(num_elements / std::min(0.5, static_cast<double>(_max_load_factor))));
+	}
+
+	void swap_pointers(split_flat_hash_map& other) {
+		using std::swap;
+		swap(hash_policy, other.hash_policy);
+		swap(metadata, other.metadata);
+		swap(values, other.values);
+		swap(num_slots_minus_one, other.num_slots_minus_one);
+		swap(num_elements, other.num_elements);
+		swap(max_lookups, other.max_lookups);
+		swap(_max_load_factor, other._max_load_factor);
+	}
+
+	// places a key that is known not to be in the table yet, robin hood style
+	template<typename... Args> iterator place_new(size_t hash, Args&&... args) {
+		uint8_t fragment = fragment_for_hash(hash);
+		Metadata* current_entry = metadata + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		int8_t distance_from_desired = 0;
+		for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+		}
+		if (distance_from_desired == max_lookups) {
+			grow();
+			return place_new(hash, std::forward<Args>(args)...);
+		} else if (current_entry->is_empty()) {
+			construct_slot(current_entry, distance_from_desired, fragment, std::forward<Args>(args)...);
+			++num_elements;
+			return { current_entry, values + (current_entry - metadata) };
+		}
+		value_type to_insert(std::forward<Args>(args)...);
+		swap_into(current_entry, distance_from_desired, fragment, to_insert);
+		Metadata* result = current_entry;
+		for (++distance_from_desired, ++current_entry;; ++current_entry) {
+			if (current_entry->is_empty()) {
+				construct_slot(current_entry, distance_from_desired, fragment, std::move(to_insert));
+				++num_elements;
+				return { result, values + (result - metadata) };
+			} else if (current_entry->distance_from_desired < distance_from_desired) {
+				swap_into(current_entry, distance_from_desired, fragment, to_insert);
+				++distance_from_desired;
+			} else {
+				++distance_from_desired;
+				if (distance_from_desired == max_lookups) {
+					// hand the displaced element back to the new one's slot, then grow and place the new one again
+					swap_into(result, distance_from_desired, fragment, to_insert);
+					grow();
+					return place_new(hash_object(to_insert.first), std::move(to_insert));
+				}
+			}
+		}
+	}
+
+	// the shared empty table has no value array to point into
+	value_type* value_for(Metadata* entry) const {
+		return values ? values + (entry - metadata) : nullptr;
+	}
+
+	void swap_into(Metadata* entry, int8_t& distance_from_desired, uint8_t& fragment, value_type& value) {
+		using std::swap;
+		swap(distance_from_desired, entry->distance_from_desired);
+		swap(fragment, entry->hash_fragment);
+		swap(value, values[entry - metadata]);
+	}
+
+	template<typename... Args> void construct_slot(Metadata* entry, int8_t distance_from_desired, uint8_t fragment, Args&&... args) {
+		ValueTraits::construct(value_alloc, values + (entry - metadata), std::forward<Args>(args)...);
+		entry->distance_from_desired = distance_from_desired;
+		entry->hash_fragment = fragment;
+	}
+	void destroy_slot(Metadata* entry) {
+		ValueTraits::destroy(value_alloc, values + (entry - metadata));
+		entry->distance_from_desired = -1;
+	}
+
+	void grow() {
+		rehash(std::max(size_t(4), 2 * bucket_count()));
+	}
+
+	void deallocate_data(Metadata* metadata_begin, value_type* values_begin, size_t num_slots_minus_one, int8_t max_lookups) {
+		if (metadata_begin != Metadata::empty_default_table()) {
+			MetadataTraits::deallocate(metadata_alloc, metadata_begin, num_slots_minus_one + max_lookups + 1 + Metadata::scan_padding);
+			ValueTraits::deallocate(value_alloc, values_begin, num_slots_minus_one + max_lookups + 1);
+		}
+	}
+
+	// folds the top byte into the bottom one, so the fragment still varies within a probe sequence whether the hash
+	// policy takes the index from the low bits (power_of_two) or the high ones (fibonacci)
+	static uint8_t fragment_for_hash(size_t hash) {
+		return static_cast<uint8_t>(hash ^ (hash >> 56));
+	}
+	template<typename U> size_t hash_object(const U& key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	template<typename L, typename R> bool compares_equal(const L& lhs, const R& rhs) const {
+		return static_cast<const E&>(*this)(lhs, rhs);
+	}
+};
@@ -0,0 +1,465 @@
+/*
+	MIT License
+
+	DiscordCoreAPI, A bot library for Discord, written in C++, and featuring explicit multithreading through the usage of custom, asynchronous C++ CoRoutines.
+
+	Copyright 2022, 2023 Chris M. (RealTimeChris)
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+/// StringArenaMap.hpp - Header file for the string_arena_map class.
+/// \file StringArenaMap.hpp
+
+#pragma once
+#include <HashMap.hpp>
+#include <string_view>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+
+namespace detailv3 {
+	// a slot of string_arena_map. the key bytes live in the map's arena, the slot only remembers where to find them,
+	// along with a byte of the key's hash so that most mismatches are rejected without ever touching the arena.
+	template<typename V> struct string_arena_entry {
+		string_arena_entry() {
+		}
+		string_arena_entry(int8_t distance_from_desired) : distance_from_desired(distance_from_desired) {
+		}
+		~string_arena_entry() {
+		}
+		static string_arena_entry* empty_default_table() {
+			static string_arena_entry result[min_lookups] = { {}, {}, {}, { special_end_value } };
+			return result;
+		}
+
+		bool has_value() const {
+			return distance_from_desired >= 0;
+		}
+		bool is_empty() const {
+			return distance_from_desired < 0;
+		}
+		bool is_at_desired_position() const {
+			return distance_from_desired <= 0;
+		}
+		template<typename... Args> void emplace(int8_t distance, uint8_t fragment, uint32_t offset, uint32_t size, Args&&... args) {
+			new (std::addressof(value)) V(std::forward<Args>(args)...);
+			distance_from_desired = distance;
+			hash_fragment = fragment;
+			key_offset = offset;
+			key_size = size;
+		}
+
+		void destroy_value() {
+			value.~V();
+			distance_from_desired = -1;
+		}
+
+		int8_t distance_from_desired = -1;
+		uint8_t hash_fragment = 0;
+		uint32_t key_offset = 0;
+		uint32_t key_size = 0;
+		static constexpr int8_t special_end_value = 0;
+		union {
+			V value;
+		};
+	};
+}
+
+// a flat_hash_map for string keys that interns every key into one append-only arena owned by the table. slots hold a
+// 32 bit offset, a 32 bit length and a hash fragment instead of a 32 byte std::string with its own heap allocation, so
+// many more of them fit in a cache line. the bytes of erased keys stay in the arena until clear() is called.
+template<typename V, typename H = std::hash<std::string_view>, typename A = std::allocator<V>> class string_arena_map : private H {
+	using Entry = detailv3::string_arena_entry<V>;
+	using EntryAlloc = typename std::allocator_traits<A>::template rebind_alloc<Entry>;
+	using AllocatorTraits = std::allocator_traits<EntryAlloc>;
+	using EntryPointer = Entry*;
+	using Arena = std::vector<char, typename std::allocator_traits<A>::template rebind_alloc<char>>;
+
+  public:
+	using key_type = std::string_view;
+	using mapped_type = V;
+	using size_type = size_t;
+	using hasher = H;
+	using allocator_type = A;
+
+	template<typename ValueType> struct templated_reference {
+		std::string_view first;
+		ValueType& second;
+	};
+	template<typename ValueType> struct templated_iterator {
+		templated_iterator() = default;
+		templated_iterator(EntryPointer current, const char* arena) : current(current), arena(arena) {
+		}
+		EntryPointer current = EntryPointer();
+		const char* arena = nullptr;
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = templated_reference<ValueType>;
+		using difference_type = ptrdiff_t;
+		using reference = templated_reference<ValueType>;
+
+		struct pointer {
+			reference value;
+			reference* operator->() {
+				return std::addressof(value);
+			}
+		};
+
+		friend bool operator==(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return lhs.current == rhs.current;
+		}
+		friend bool operator!=(const templated_iterator& lhs, const templated_iterator& rhs) {
+			return !(lhs == rhs);
+		}
+
+		templated_iterator& operator++() {
+			do {
+				++current;
+			} while (current->is_empty());
+			return *this;
+		}
+		templated_iterator operator++(int32_t) {
+			templated_iterator copy(*this);
+			++*this;
+			return copy;
+		}
+
+		reference operator*() const {
+			return { std::string_view{ arena + current->key_offset, current->key_size }, current->value };
+		}
+		pointer operator->() const {
+			return { **this };
+		}
+
+		operator templated_iterator<const V>() const {
+			return { current, arena };
+		}
+	};
+	using iterator = templated_iterator<V>;
+	using const_iterator = templated_iterator<const V>;
+
+	string_arena_map() {
+	}
+	explicit string_arena_map(size_type bucket_count, const H& hash = H(), const A& alloc = A()) : H(hash), entry_alloc(alloc), arena(alloc) {
+		rehash(bucket_count);
+	}
+	string_arena_map(const string_arena_map& other) : H(other), entry_alloc(other.entry_alloc), arena(other.arena), _max_load_factor(other._max_load_factor),
+		  _min_load_factor(other._min_load_factor) {
+		rehash(std::min(num_buckets_for_reserve(other.size()), other.bucket_count()));
+		for (EntryPointer it = other.entries, end = it + static_cast<ptrdiff_t>(other.num_slots_minus_one + other.max_lookups); it != end; ++it) {
+			if (it->has_value())
+				place_interned(it->key_offset, it->key_size, it->value);
+		}
+	}
+	string_arena_map(string_arena_map&& other) noexcept : H(std::move(other)), entry_alloc(std::move(other.entry_alloc)) {
+		swap_pointers(other);
+	}
+	string_arena_map& operator=(string_arena_map other) {
+		static_cast<H&>(*this) = std::move(static_cast<H&>(other));
+		swap_pointers(other);
+		return *this;
+	}
+	~string_arena_map() {
+		clear();
+		deallocate_data(entries, num_slots_minus_one, max_lookups);
+	}
+
+	iterator begin() {
+		for (EntryPointer it = entries;; ++it) {
+			if (it->has_value())
+				return { it, arena.data() };
+		}
+	}
+	const_iterator begin() const {
+		return const_cast<string_arena_map*>(this)->begin();
+	}
+	iterator end() {
+		return { entries + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups), arena.data() };
+	}
+	const_iterator end() const {
+		return const_cast<string_arena_map*>(this)->end();
+	}
+
+	iterator find(std::string_view key) {
+		size_t hash = hash_object(key);
+		uint8_t fragment = fragment_for_hash(hash);
+		EntryPointer it = entries + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		for (int8_t distance = 0; it->distance_from_desired >= distance; ++distance, ++it) {
+			if (compares_equal(key, fragment, *it))
+				return { it, arena.data() };
+		}
+		return end();
+	}
+	const_iterator find(std::string_view key) const {
+		return const_cast<string_arena_map*>(this)->find(key);
+	}
+	size_t count(std::string_view key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+
+	template<typename... Args> std::pair<iterator, bool> emplace(std::string_view key, Args&&... args) {
+		size_t hash = hash_object(key);
+		uint8_t fragment = fragment_for_hash(hash);
+		EntryPointer current_entry = entries + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		int8_t distance_from_desired = 0;
+		for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+			if (compares_equal(key, fragment, *current_entry))
+				return { { current_entry, arena.data() }, false };
+		}
+		if (num_slots_minus_one == 0 || distance_from_desired == max_lookups || num_elements + 1 > (num_slots_minus_one + 1) * static_cast<double>(_max_load_factor)) {
+			grow();
+			return emplace(key, std::forward<Args>(args)...);
+		}
+		uint32_t offset = intern(key);
+		return { { place_interned(offset, static_cast<uint32_t>(key.size()), std::forward<Args>(args)...), arena.data() }, true };
+	}
+	V& operator[](std::string_view key) {
+		return emplace(key).first->second;
+	}
+	V& at(std::string_view key) {
+		auto found = find(key);
+		if (found == end())
+			throw std::out_of_range("Argument passed to at() was not in the map.");
+		return found->second;
+	}
+
+	void erase(const_iterator to_erase) {
+		EntryPointer current = to_erase.current;
+		current->destroy_value();
+		--num_elements;
+		for (EntryPointer next = current + ptrdiff_t(1); !next->is_at_desired_position(); ++current, ++next) {
+			current->emplace(next->distance_from_desired - 1, next->hash_fragment, next->key_offset, next->key_size, std::move(next->value));
+			next->destroy_value();
+		}
+	}
+	size_t erase(std::string_view key) {
+		auto found = find(key);
+		if (found == end())
+			return 0;
+		erase(found);
+		if (num_elements < bucket_count() * static_cast<double>(_min_load_factor))
+			shrink_to_fit();
+		return 1;
+	}
+
+	void clear() {
+		for (EntryPointer it = entries, end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
+			if (it->has_value())
+				it->destroy_value();
+		}
+		num_elements = 0;
+		arena.clear();
+	}
+
+	void rehash(size_t num_buckets) {
+		num_buckets = std::max(num_buckets, static_cast<size_t>(std::ceil(num_elements / static_cast<double>(_max_load_factor))));
+		if (num_buckets == 0) {
+			return;
+		}
+		auto new_shift = hash_policy.next_size_over(num_buckets);
+		if (num_buckets == bucket_count())
+			return;
+		int8_t new_max_lookups = std::max(detailv3::min_lookups, detailv3::log2(num_buckets));
+		EntryPointer new_buckets(AllocatorTraits::allocate(entry_alloc, num_buckets + new_max_lookups));
+		EntryPointer special_end_item = new_buckets + static_cast<ptrdiff_t>(num_buckets + new_max_lookups - 1);
+		for (EntryPointer it = new_buckets; it != special_end_item; ++it)
+			it->distance_from_desired = -1;
+		special_end_item->distance_from_desired = Entry::special_end_value;
+		std::swap(entries, new_buckets);
+		std::swap(num_slots_minus_one, num_buckets);
+		--num_slots_minus_one;
+		hash_policy.commit(new_shift);
+		int8_t old_max_lookups = max_lookups;
+		max_lookups = new_max_lookups;
+		num_elements = 0;
+		for (EntryPointer it = new_buckets, end = it + static_cast<ptrdiff_t>(num_buckets + old_max_lookups); it != end; ++it) {
+			if (it->has_value()) {
+				place_interned(it->key_offset, it->key_size, std::move(it->value));
+				it->destroy_value();
+			}
+		}
+		deallocate_data(new_buckets, num_buckets, old_max_lookups);
+	}
+	void reserve(size_t num_elements) {
+		size_t required_buckets = num_buckets_for_reserve(num_elements);
+		if (required_buckets > bucket_count())
+			rehash(required_buckets);
+	}
+	void shrink_to_fit() {
+		rehash(std::min(num_buckets_for_reserve(num_elements), bucket_count()));
+	}
+	// shrink_to_fit(), then rewrites the arena with only the keys that are still in the table. the bytes of erased keys
+	// are otherwise only given back by clear()
+	void compact() {
+		shrink_to_fit();
+		size_t live_bytes = 0;
+		for (EntryPointer it = entries, end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
+			if (it->has_value())
+				live_bytes += it->key_size;
+		}
+		Arena packed(arena.get_allocator());
+		packed.reserve(live_bytes);
+		for (EntryPointer it = entries, end = it + static_cast<ptrdiff_t>(num_slots_minus_one + max_lookups); it != end; ++it) {
+			if (it->has_value()) {
+				uint32_t offset = static_cast<uint32_t>(packed.size());
+				packed.insert(packed.end(), arena.data() + it->key_offset, arena.data() + it->key_offset + it->key_size);
+				it->key_offset = offset;
+			}
+		}
+		arena.swap(packed);
+	}
+
+	size_t size() const {
+		return num_elements;
+	}
+	bool empty() const {
+		return num_elements == 0;
+	}
+	size_t bucket_count() const {
+		return num_slots_minus_one ? num_slots_minus_one + 1 : 0;
+	}
+	float load_factor() const {
+		size_t buckets = bucket_count();
+		return buckets ? static_cast<float>(num_elements) / buckets : 0;
+	}
+	void max_load_factor(float value) {
+		_max_load_factor = value;
+	}
+	float max_load_factor() const {
+		return _max_load_factor;
+	}
+	// the same shrink on erase as flat_hash_map::min_load_factor(), which explains its cap and hysteresis. it only gives
+	// back slots, the arena needs compact()
+	void min_load_factor(float value) {
+		_min_load_factor = std::clamp(value, 0.0f, _max_load_factor / 4);
+	}
+	float min_load_factor() const {
+		return _min_load_factor;
+	}
+	// bytes held by the slot array and the key arena, including the bytes of erased keys
+	size_t memory_usage() const {
+		return (num_slots_minus_one ? (num_slots_minus_one + max_lookups + 1) * sizeof(Entry) : 0) + arena.capacity();
+	}
+	size_t arena_size() const {
+		return arena.size();
+	}
+
+  private:
+	EntryPointer entries = Entry::empty_default_table();
+	size_t num_slots_minus_one = 0;
+	fibonacci_hash_policy hash_policy;
+	int8_t max_lookups = detailv3::min_lookups - 1;
+	float _max_load_factor = 0.5f;
+	float _min_load_factor = 0.0f;
+	size_t num_elements = 0;
+	EntryAlloc entry_alloc;
+	Arena arena;
+
+	size_t num_buckets_for_reserve(size_t num_elements) const {
+		return static_cast<size_t>(std::ceil(num_elements / std::min(0.5, static_cast<double>(_max_load_factor))));
+	}
+
+	void swap_pointers(string_arena_map& other) {
+		using std::swap;
+		swap(hash_policy, other.hash_policy);
+		swap(entries, other.entries);
+		swap(num_slots_minus_one, other.num_slots_minus_one);
+		swap(num_elements, other.num_elements);
+		swap(max_lookups, other.max_lookups);
+		swap(_max_load_factor, other._max_load_factor);
+		swap(_min_load_factor, other._min_load_factor);
+		swap(arena, other.arena);
+	}
+
+	uint32_t intern(std::string_view key) {
+		if (arena.size() + key.size() > std::numeric_limits<uint32_t>::max())
+			throw std::length_error("string_arena_map ran out of 32 bit key offsets.");
+		uint32_t offset = static_cast<uint32_t>(arena.size());
+		arena.insert(arena.end(), key.begin(), key.end());
+		return offset;
+	}
+
+	// places a key that is already in the arena and known not to be in the table yet, robin hood style
+	template<typename... Args> EntryPointer place_interned(uint32_t key_offset, uint32_t key_size, Args&&... args) {
+		size_t hash = hash_object(std::string_view{ arena.data() + key_offset, key_size });
+		uint8_t fragment = fragment_for_hash(hash);
+		EntryPointer current_entry = entries + ptrdiff_t(hash_policy.index_for_hash(hash, num_slots_minus_one));
+		int8_t distance_from_desired = 0;
+		for (; current_entry->distance_from_desired >= distance_from_desired; ++current_entry, ++distance_from_desired) {
+		}
+		if (distance_from_desired == max_lookups) {
+			grow();
+			return place_interned(key_offset, key_size, std::forward<Args>(args)...);
+		} else if (current_entry->is_empty()) {
+			current_entry->emplace(distance_from_desired, fragment, key_offset, key_size, std::forward<Args>(args)...);
+			++num_elements;
+			return current_entry;
+		}
+		V to_insert(std::forward<Args>(args)...);
+		swap_into(current_entry, distance_from_desired, fragment, key_offset, key_size, to_insert);
+		EntryPointer result = current_entry;
+		for (++distance_from_desired, ++current_entry;; ++current_entry) {
+			if (current_entry->is_empty()) {
+				current_entry->emplace(distance_from_desired, fragment, key_offset, key_size, std::move(to_insert));
+				++num_elements;
+				return result;
+			} else if (current_entry->distance_from_desired < distance_from_desired) {
+				swap_into(current_entry, distance_from_desired, fragment, key_offset, key_size, to_insert);
+				++distance_from_desired;
+			} else {
+				++distance_from_desired;
+				if (distance_from_desired == max_lookups) {
+					// hand the displaced element back to the new one's slot, then grow and place the new one again
+					swap_into(result, distance_from_desired, fragment, key_offset, key_size, to_insert);
+					grow();
+					return place_interned(key_offset, key_size, std::move(to_insert));
+				}
+			}
+		}
+	}
+
+	void swap_into(EntryPointer entry, int8_t& distance_from_desired, uint8_t& fragment, uint32_t& key_offset, uint32_t& key_size, V& value) {
+		using std::swap;
+		swap(distance_from_desired, entry->distance_from_desired);
+		swap(fragment, entry->hash_fragment);
+		swap(key_offset, entry->key_offset);
+		swap(key_size, entry->key_size);
+		swap(value, entry->value);
+	}
+
+	void grow() {
+		rehash(std::max(size_t(4), 2 * bucket_count()));
+	}
+
+	void deallocate_data(EntryPointer begin, size_t num_slots_minus_one, int8_t max_lookups) {
+		if (begin != Entry::empty_default_table()) {
+			AllocatorTraits::deallocate(entry_alloc, begin, num_slots_minus_one + max_lookups + 1);
+		}
+	}
+
+	static uint8_t fragment_for_hash(size_t hash) {
+		return static_cast<uint8_t>(hash);
+	}
+	size_t hash_object(std::string_view key) const {
+		return static_cast<const H&>(*this)(key);
+	}
+	bool compares_equal(std::string_view key, uint8_t fragment, const Entry& entry) const {
+		return entry.hash_fragment == fragment && entry.key_size == key.size() && std::memcmp(arena.data() + entry.key_offset, key.data(), key.size()) == 0;
+	}
+};
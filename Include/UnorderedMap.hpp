@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <SlotArrayPool.hpp>
+#include <BloomFilter.hpp>
+#include <HashMath.hpp>
 #include <memory_resource>
 #include <shared_mutex>
 #include <exception>
@@ -38,6 +41,13 @@
 #include <mutex>
 #include <ostream>
 #include <concepts>
+#include <cmath>
+#include <cstring>
+#include <bit>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
 
 namespace DiscordCoreAPI {
 
@@ -116,6 +126,10 @@ namespace DiscordCoreAPI {
 			return internalHashFunction(other.data(), other.size());
 		}
 
+		inline uint64_t operator()(const std::pmr::string& other) const {
+			return internalHashFunction(other.data(), other.size());
+		}
+
 		inline uint64_t operator()(const std::string_view& other) const {
 			return internalHashFunction(other.data(), other.size());
 		}
@@ -141,12 +155,18 @@ namespace DiscordCoreAPI {
 		}
 	};
 
+	// the default policy: the next prime rounded up to a power of two, and a mask. other policies have the same shape -
+	// indexForHash() maps a hash into [0, capacityVal), nextSizeOver() picks the capacity for a requested size and
+	// commit() is told once the map has switched to that capacity.
 	template<typename ValueType> struct HashPolicy {
 	  public:
 		inline uint64_t indexForHash(uint64_t hash) const {
 			return (hash & static_cast<const ValueType*>(this)->capacityVal - 1);
 		}
 
+		inline void commit(uint64_t) {
+		}
+
 		inline uint64_t nextSizeOver(uint64_t size) const {
 			size = static_cast<uint64_t>(HashPolicy::nextSizeOverPrime(size));
 			--size;
@@ -439,6 +459,77 @@ namespace DiscordCoreAPI {
 		}
 	};
 
+	// a power of two capacity without going through the prime table first, so reserve(n) never allocates close to 4n.
+	template<typename ValueType> struct PowerOfTwoHashPolicy {
+	  public:
+		inline uint64_t indexForHash(uint64_t hash) const {
+			return hash & (static_cast<const ValueType*>(this)->capacityVal - 1);
+		}
+
+		inline uint64_t nextSizeOver(uint64_t size) const {
+			return std::bit_ceil(std::max(size, uint64_t{ 2 }));
+		}
+
+		inline void commit(uint64_t) {
+		}
+	};
+
+	// a power of two capacity, indexed by the top bits of hash * 2^64 / phi. low bits that hardly change from key to
+	// key (FNV over small integers) still spread out over the whole table.
+	template<typename ValueType> struct FibonacciHashPolicy {
+	  public:
+		inline uint64_t indexForHash(uint64_t hash) const {
+			return (11400714819323198485ull * hash) >> shift;
+		}
+
+		inline uint64_t nextSizeOver(uint64_t size) const {
+			return std::bit_ceil(std::max(size, uint64_t{ 2 }));
+		}
+
+		inline void commit(uint64_t capacityNew) {
+			shift = static_cast<int8_t>(64 - std::countr_zero(capacityNew));
+		}
+
+	  protected:
+		int8_t shift{ 63 };
+	};
+
+	// a true prime capacity, reduced with detailv3::fastmod_reciprocal instead of a division, as flat_hash_map's
+	// fastmod_prime_hash_policy does.
+	template<typename ValueType> struct PrimeHashPolicy : public HashPolicy<ValueType> {
+	  public:
+		inline uint64_t indexForHash(uint64_t hash) const {
+			return reciprocal.remainder(hash);
+		}
+
+		inline uint64_t nextSizeOver(uint64_t size) const {
+			return static_cast<uint64_t>(HashPolicy<ValueType>::nextSizeOverPrime(size));
+		}
+
+		inline void commit(uint64_t capacityNew) {
+			reciprocal.commit(capacityNew);
+		}
+
+	  protected:
+		detailv3::fastmod_reciprocal reciprocal{};
+	};
+
+	// Lemire's fast range: (hash * capacityVal) >> 64. works for any capacity, so the map gets exactly the size it
+	// asked for, and only the high bits of the hash matter.
+	template<typename ValueType> struct FastRangeHashPolicy {
+	  public:
+		inline uint64_t indexForHash(uint64_t hash) const {
+			return detailv3::mul_high(hash, static_cast<const ValueType*>(this)->capacityVal);
+		}
+
+		inline uint64_t nextSizeOver(uint64_t size) const {
+			return std::max(size, uint64_t{ 2 });
+		}
+
+		inline void commit(uint64_t) {
+		}
+	};
+
 	template<typename FirstType, typename SecondType> class Pair {
 	  public:
 		using first_type = FirstType;
@@ -460,6 +551,18 @@ namespace DiscordCoreAPI {
 		}
 	};
 
+	template<typename ValueType> struct IsTriviallyRelocatable
+		: std::bool_constant<std::is_trivially_move_constructible_v<ValueType> && std::is_trivially_destructible_v<ValueType>> {};
+
+	template<typename FirstType, typename SecondType> struct IsTriviallyRelocatable<Pair<FirstType, SecondType>>
+		: std::bool_constant<IsTriviallyRelocatable<FirstType>::value && IsTriviallyRelocatable<SecondType>::value> {};
+
+	template<typename ValueType>
+	concept TriviallyRelocatableT = IsTriviallyRelocatable<ValueType>::value;
+
+	template<typename ValueType>
+	concept TriviallyCopyableT = std::is_trivially_copy_constructible_v<ValueType> && std::is_trivially_destructible_v<ValueType>;
+
 	template<typename ValueTypeInternal> class HashIterator {
 	  public:
 		using iterator_category = std::forward_iterator_tag;
@@ -506,8 +609,9 @@ namespace DiscordCoreAPI {
 			return value;
 		}
 
+		// find() returns a default constructed iterator on a miss, which has no slot to look at.
 		inline bool operator==(const HashIterator&) const {
-			return value->areWeDone();
+			return !value || value->areWeDone();
 		}
 
 		inline const_pointer operator->() const {
@@ -538,7 +642,33 @@ namespace DiscordCoreAPI {
 		}
 	};
 
-	template<typename ValueType> struct ObjectCore {
+	// with StoreHash a slot keeps its key's full hash as well, and a probe only compares keys whose hashes already match.
+	// it also means a resize never has to hash a key again.
+	template<bool StoreHash> struct ObjectCoreHash {
+		inline static constexpr bool storesHash{ false };
+
+		inline bool hashMatches(uint64_t) const {
+			return true;
+		}
+
+		inline void setHash(uint64_t) {
+		}
+	};
+
+	template<> struct ObjectCoreHash<true> {
+		inline static constexpr bool storesHash{ true };
+		uint64_t hash{};
+
+		inline bool hashMatches(uint64_t other) const {
+			return hash == other;
+		}
+
+		inline void setHash(uint64_t hashNew) {
+			hash = hashNew;
+		}
+	};
+
+	template<typename ValueType, bool StoreHash = false> struct ObjectCore : public ObjectCoreHash<StoreHash> {
 		using value_type = ValueType;
 
 		union {
@@ -588,28 +718,43 @@ namespace DiscordCoreAPI {
 		}
 	};
 
-	template<typename KeyType, typename ValueType> class UnorderedMap;
-
-	template<typename MapIterator, typename KeyType, typename ValueType>
-	concept MapContainerIteratorT = std::is_same_v<typename UnorderedMap<KeyType, ValueType>::iterator, std::decay_t<MapIterator>>;
+	template<typename KeyType, typename ValueType, typename AllocatorType = JsonifierInternal::AllocWrapper<ObjectCore<Pair<KeyType, ValueType>>>,
+		template<typename> class HashPolicyType = HashPolicy, bool NegativeLookupFilter = false, bool StoreHash = false>
+	class UnorderedMap;
 
-	template<typename KeyType, typename ValueType> class UnorderedMap
-		: protected HashPolicy<UnorderedMap<KeyType, ValueType>>,
-		  protected JsonifierInternal::AllocWrapper<ObjectCore<Pair<KeyType, ValueType>>>,
-		  protected ObjectCompare,
-		  protected KeyHasher {
+	template<typename ValueType>
+	concept PolymorphicAllocatorT = std::same_as<ValueType, std::pmr::polymorphic_allocator<typename ValueType::value_type>>;
+
+	// the map's own iterator, whatever its template arguments. const_iterator decays to the same type
+	template<typename MapIterator, typename MapType>
+	concept MapContainerIteratorT = std::is_same_v<typename MapType::iterator, std::decay_t<MapIterator>>;
+
+	// NegativeLookupFilter keeps a blocked bloom filter of the keys next to the slots. find(), contains() and erase() ask it
+	// before touching the slots, so most lookups for keys that aren't there cost a single cache line. erased keys drop out
+	// of it when rebuild() resizes it, or when churn has put more keys through it than it was sized for.
+	//
+	// StoreHash keeps each key's full hash in its slot, which pays for its 8 bytes when keys are slow to compare, such as
+	// long strings with shared prefixes. the allocator is rebound to the slot type either way.
+	template<typename KeyType, typename ValueType, typename AllocatorType, template<typename> class HashPolicyType, bool NegativeLookupFilter,
+		bool StoreHash>
+	class UnorderedMap : protected HashPolicyType<UnorderedMap<KeyType, ValueType, AllocatorType, HashPolicyType, NegativeLookupFilter, StoreHash>>,
+						 protected std::allocator_traits<AllocatorType>::template rebind_alloc<ObjectCore<Pair<KeyType, ValueType>, StoreHash>>,
+						 protected ObjectCompare,
+						 protected KeyHasher,
+						 protected detailv3::lookup_filter<NegativeLookupFilter> {
 	  public:
 		using mapped_type = ValueType;
 		using key_type = KeyType;
 		using reference = mapped_type&;
 		using value_type = Pair<key_type, mapped_type>;
-		using value_type_internal = ObjectCore<Pair<key_type, mapped_type>>;
+		using value_type_internal = ObjectCore<Pair<key_type, mapped_type>, StoreHash>;
 		using const_reference = const mapped_type&;
 		using size_type = uint64_t;
 		using key_hasher = KeyHasher;
 		using pointer = value_type_internal*;
 		using object_compare = ObjectCompare;
-		using hash_policy = HashPolicy<UnorderedMap<key_type, mapped_type>>;
+		using hash_policy = HashPolicyType<UnorderedMap<key_type, mapped_type, AllocatorType, HashPolicyType, NegativeLookupFilter, StoreHash>>;
+		using lookup_filter = detailv3::lookup_filter<NegativeLookupFilter>;
 		friend hash_policy;
 
 		using iterator = HashIterator<value_type_internal>;
@@ -618,9 +763,10 @@ namespace DiscordCoreAPI {
 		friend const_iterator;
 
 		inline static constexpr int8_t minimumLookups{ 4 };
-		inline static int8_t currentMaxLookupDistance{ minimumLookups };
 
-		using allocator = JsonifierInternal::AllocWrapper<value_type_internal>;
+		using allocator = typename std::allocator_traits<AllocatorType>::template rebind_alloc<value_type_internal>;
+		using allocator_type = allocator;
+		using allocator_traits = std::allocator_traits<allocator>;
 
 		class LocalIterator {
 		  public:
@@ -633,7 +779,8 @@ namespace DiscordCoreAPI {
 			using pointer_internal = value_type_internal*;
 			using size_type = uint64_t;
 
-			inline constexpr LocalIterator(value_type_internal* valueNew) : currentValue{ valueNew }, startValue{ valueNew } {};
+			inline constexpr LocalIterator(value_type_internal* valueNew, int8_t maxLookupDistanceNew)
+				: currentValue{ valueNew }, startValue{ valueNew }, maxLookupDistance{ maxLookupDistanceNew } {};
 
 			inline constexpr LocalIterator& operator++() {
 				++currentValue;
@@ -650,7 +797,7 @@ namespace DiscordCoreAPI {
 			}
 
 			inline constexpr bool operator==(const LocalIterator&) const {
-				return currentValue - startValue >= currentMaxLookupDistance;
+				return currentValue - startValue >= maxLookupDistance;
 			}
 
 			inline constexpr const_pointer operator->() const {
@@ -674,9 +821,11 @@ namespace DiscordCoreAPI {
 		  protected:
 			mutable pointer_internal currentValue{};
 			mutable pointer_internal startValue{};
+			int8_t maxLookupDistance{};
 
+			// stops at the end of the probe window too, so a miss near the end of the array can't run off of it
 			inline constexpr void skipEmptySlots() const {
-				while (currentValue->areWeEmpty() && !currentValue->areWeDone()) {
+				while (currentValue - startValue < maxLookupDistance && currentValue->areWeEmpty() && !currentValue->areWeDone()) {
 					currentValue++;
 				};
 			}
@@ -686,22 +835,54 @@ namespace DiscordCoreAPI {
 			reserve(capacityNew);
 		};
 
-		inline UnorderedMap& operator=(UnorderedMap&& other) noexcept {
+		inline UnorderedMap(size_type capacityNew, const allocator_type& allocatorNew) : allocator{ allocatorNew } {
+			reserve(capacityNew);
+		};
+
+		inline explicit UnorderedMap(const allocator_type& allocatorNew) : UnorderedMap{ 16, allocatorNew } {};
+
+		// only an allocator that moves with the slots, or that can't differ, makes this a swap that can't throw. otherwise
+		// unequal allocators mean moving the elements one by one onto this map's allocator.
+		inline UnorderedMap& operator=(UnorderedMap&& other) noexcept(
+			allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value) {
 			if (this != &other) {
 				clear();
-				swap(other);
+				if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+					static_cast<allocator&>(*this) = std::move(static_cast<allocator&>(other));
+					swap(other);
+				} else if (getAlloc() == other.getAlloc()) {
+					swap(other);
+				} else {
+					maxLoadFactor = other.maxLoadFactor;
+					minLoadFactor = other.minLoadFactor;
+					growthFactor = other.growthFactor;
+					reserve(other.capacity());
+					for (auto& [key, value]: other) {
+						emplace(std::move(key), std::move(value));
+					}
+					other.clear();
+				}
 			}
 			return *this;
 		}
 
-		inline UnorderedMap(UnorderedMap&& other) noexcept {
+		inline UnorderedMap(UnorderedMap&& other) noexcept : allocator{ other.getAlloc() } {
 			*this = std::move(other);
 		}
 
 		inline UnorderedMap& operator=(const UnorderedMap& other) {
 			if (this != &other) {
 				clear();
-
+				maxLoadFactor = other.maxLoadFactor;
+				minLoadFactor = other.minLoadFactor;
+				growthFactor = other.growthFactor;
+
+				if constexpr (TriviallyCopyableT<value_type>) {
+					if (other.data && other.capacityVal > 0) {
+						copySlots(other);
+						return *this;
+					}
+				}
 				reserve(other.capacity());
 				for (const auto& [key, value]: other) {
 					emplace(key, value);
@@ -722,27 +903,18 @@ namespace DiscordCoreAPI {
 		};
 
 		template<typename key_type_new, typename... Args> inline iterator emplace(key_type_new&& key, Args&&... value) {
-			pointer currentEntry = data + hash_policy::indexForHash(key_hasher()(key));
-			for (size_type x{}; x < currentMaxLookupDistance; ++x, ++currentEntry) {
-				if (currentEntry->areWeEmpty()) {
-					currentEntry->enable(std::forward<key_type_new>(key), std::forward<Args>(value)...);
-					sizeVal++;
-					return currentEntry;
-				} else if (currentEntry->areWeActive() && object_compare()(currentEntry->value.first, key)) {
-					currentEntry->value.second.~mapped_type();
-					currentEntry->value = mapped_type{ std::forward<Args>(value)... };
-					return currentEntry;
-				}
-			}
-			resize(capacityVal + capacityVal + 2);
-			return emplace(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			return emplaceInternal(key_hasher()(key), std::forward<key_type_new>(key), std::forward<Args>(value)...);
 		}
 
 		template<typename key_type_new> inline const_iterator find(key_type_new&& key) const {
 			if (capacityVal > 0) {
-				LocalIterator currentEntry{ data + hash_policy::indexForHash(key_hasher()(key)) };
+				auto hash = key_hasher()(key);
+				if (!this->filter_may_contain(hash)) {
+					return end();
+				}
+				LocalIterator currentEntry{ data + hash_policy::indexForHash(hash), currentMaxLookupDistance };
 				for (; currentEntry != currentEntry; ++currentEntry) {
-					if (object_compare()(currentEntry->first, key)) {
+					if (currentEntry.getRawPtr()->areWeActive() && currentEntry.getRawPtr()->hashMatches(hash) && object_compare()(currentEntry->first, key)) {
 						return currentEntry;
 					}
 				}
@@ -752,9 +924,13 @@ namespace DiscordCoreAPI {
 
 		template<typename key_type_new> inline iterator find(key_type_new&& key) {
 			if (capacityVal > 0) {
-				LocalIterator currentEntry{ data + hash_policy::indexForHash(key_hasher()(key)) };
+				auto hash = key_hasher()(key);
+				if (!this->filter_may_contain(hash)) {
+					return end();
+				}
+				LocalIterator currentEntry{ data + hash_policy::indexForHash(hash), currentMaxLookupDistance };
 				for (; currentEntry != currentEntry; ++currentEntry) {
-					if (object_compare()(currentEntry->first, key)) {
+					if (currentEntry.getRawPtr()->areWeActive() && currentEntry.getRawPtr()->hashMatches(hash) && object_compare()(currentEntry->first, key)) {
 						return currentEntry;
 					}
 				}
@@ -788,9 +964,13 @@ namespace DiscordCoreAPI {
 
 		template<typename key_type_new> inline bool contains(key_type_new&& key) const {
 			if (capacityVal > 0) {
-				LocalIterator currentEntry{ data + hash_policy::indexForHash(key_hasher()(key)) };
+				auto hash = key_hasher()(key);
+				if (!this->filter_may_contain(hash)) {
+					return false;
+				}
+				LocalIterator currentEntry{ data + hash_policy::indexForHash(hash), currentMaxLookupDistance };
 				for (; currentEntry != currentEntry; ++currentEntry) {
-					if (object_compare()(currentEntry->first, key)) {
+					if (currentEntry.getRawPtr()->areWeActive() && currentEntry.getRawPtr()->hashMatches(hash) && object_compare()(currentEntry->first, key)) {
 						return true;
 					}
 				}
@@ -798,13 +978,14 @@ namespace DiscordCoreAPI {
 			return false;
 		}
 
-		template<MapContainerIteratorT<key_type, mapped_type> MapIterator> inline iterator erase(MapIterator&& iter) {
+		template<MapContainerIteratorT<UnorderedMap> MapIterator> inline iterator erase(MapIterator&& iter) {
 			if (capacityVal > 0) {
-				LocalIterator currentEntry{ data + static_cast<size_type>(iter.getRawPtr() - data) };
+				LocalIterator currentEntry{ data + static_cast<size_type>(iter.getRawPtr() - data), currentMaxLookupDistance };
 				for (; currentEntry != currentEntry; ++currentEntry) {
 					if (object_compare()(currentEntry->first, iter.operator*().first)) {
 						currentEntry.getRawPtr()->disable();
 						sizeVal--;
+						erasedSlots++;
 						return ++currentEntry;
 					}
 				}
@@ -812,13 +993,23 @@ namespace DiscordCoreAPI {
 			return end();
 		}
 
+		// with min_load_factor() set this may rebuild the map at a smaller size, in which case it returns end().
 		template<typename key_type_new> inline iterator erase(key_type_new&& key) {
 			if (capacityVal > 0) {
-				LocalIterator currentEntry{ data + hash_policy::indexForHash(key_hasher()(key)) };
+				auto hash = key_hasher()(key);
+				if (!this->filter_may_contain(hash)) {
+					return end();
+				}
+				LocalIterator currentEntry{ data + hash_policy::indexForHash(hash), currentMaxLookupDistance };
 				for (; currentEntry != currentEntry; ++currentEntry) {
-					if (object_compare()(currentEntry->first, key)) {
+					if (currentEntry.getRawPtr()->areWeActive() && currentEntry.getRawPtr()->hashMatches(hash) && object_compare()(currentEntry->first, key)) {
 						currentEntry.getRawPtr()->disable();
 						sizeVal--;
+						erasedSlots++;
+						if (static_cast<float>(sizeVal) < static_cast<float>(capacityVal) * minLoadFactor) {
+							shrink_to_fit();
+							return end();
+						}
 						return ++currentEntry;
 					}
 				}
@@ -843,7 +1034,61 @@ namespace DiscordCoreAPI {
 		}
 
 		inline bool full() const {
-			return static_cast<float>(sizeVal) >= static_cast<float>(capacityVal) * 0.90f;
+			return static_cast<float>(sizeVal) >= static_cast<float>(capacityVal) * maxLoadFactor;
+		}
+
+		inline float load_factor() const {
+			return capacityVal > 0 ? static_cast<float>(sizeVal) / static_cast<float>(capacityVal) : 0.0f;
+		}
+
+		inline float max_load_factor() const {
+			return maxLoadFactor;
+		}
+
+		// how full the map may get before an insert grows it. it also grows whenever a key can't find a free slot within
+		// currentMaxLookupDistance of its home, so a high value trades probe length for memory rather than forcing it.
+		inline void max_load_factor(float maxLoadFactorNew) {
+			maxLoadFactor = std::clamp(maxLoadFactorNew, 0.05f, 1.0f);
+		}
+
+		inline float growth_factor() const {
+			return growthFactor;
+		}
+
+		// how much the capacity is multiplied by each time the map grows.
+		inline void growth_factor(float growthFactorNew) {
+			growthFactor = std::max(growthFactorNew, 1.125f);
+		}
+
+		inline float min_load_factor() const {
+			return minLoadFactor;
+		}
+
+		// opts in to shrinking on erase by key, with the same cap and hysteresis as flat_hash_map::min_load_factor(),
+		// which explains them. 0, the default, turns it off.
+		inline void min_load_factor(float minLoadFactorNew) {
+			minLoadFactor = std::clamp(minLoadFactorNew, 0.0f, maxLoadFactor / 4.0f);
+		}
+
+		// the keys and values own their storage, so compacting is a rebuild at the smallest size that fits. it rebuilds even
+		// when the size doesn't change if erase has left holes, so inserts go back to stopping at the first empty slot.
+		inline void compact() {
+			if (data && capacityVal > 0) {
+				auto newSize = hash_policy::nextSizeOver(capacityFor(sizeVal));
+				if (newSize < capacityVal || erasedSlots > 0) {
+					rebuild(std::min(newSize, capacityVal));
+				}
+			}
+		}
+
+		// rebuilds the map at the smallest capacity that holds its current elements under max_load_factor().
+		inline void shrink_to_fit() {
+			if (data && capacityVal > 0) {
+				auto newSize = hash_policy::nextSizeOver(capacityFor(sizeVal));
+				if (newSize < capacityVal) {
+					rebuild(newSize);
+				}
+			}
 		}
 
 		inline size_type size() const {
@@ -856,19 +1101,30 @@ namespace DiscordCoreAPI {
 
 		inline void reserve(size_type sizeNew) {
 			sizeNew = sizeNew == 0 ? 4 : sizeNew;
-			resize(sizeNew);
+			resize(capacityFor(sizeNew));
 		}
 
 		inline void swap(UnorderedMap& other) noexcept {
 			std::swap(capacityVal, other.capacityVal);
 			std::swap(sizeVal, other.sizeVal);
 			std::swap(data, other.data);
+			std::swap(currentMaxLookupDistance, other.currentMaxLookupDistance);
+			std::swap(erasedSlots, other.erasedSlots);
+			std::swap(maxLoadFactor, other.maxLoadFactor);
+			std::swap(minLoadFactor, other.minLoadFactor);
+			std::swap(growthFactor, other.growthFactor);
+			std::swap(static_cast<hash_policy&>(*this), static_cast<hash_policy&>(other));
+			this->filter_swap(other);
 		}
 
 		inline size_type capacity() const {
 			return capacityVal;
 		}
 
+		inline allocator_type get_allocator() const {
+			return getAlloc();
+		}
+
 		inline bool operator==(const UnorderedMap& other) const {
 			if (capacityVal != other.capacityVal || sizeVal != other.sizeVal || data != other.data) {
 				return false;
@@ -883,11 +1139,25 @@ namespace DiscordCoreAPI {
 
 		inline void clear() {
 			if (data && capacityVal > 0) {
-				std::destroy(data, data + capacityVal);
-				allocator::deallocate(data, capacityVal);
+				std::destroy(data, data + capacityVal + currentMaxLookupDistance);
+				allocator::deallocate(data, capacityVal + 1 + currentMaxLookupDistance);
 				sizeVal = 0;
+				erasedSlots = 0;
 				capacityVal = 0;
 				data = nullptr;
+				this->filter_release();
+			}
+		}
+
+		// destroys every element but hangs on to the slots, so the map can be refilled without going back to the allocator.
+		inline void reset() {
+			if (data && capacityVal > 0) {
+				for (size_type x = 0; x < capacityVal + currentMaxLookupDistance; ++x) {
+					data[x].disable();
+				}
+				sizeVal = 0;
+				erasedSlots = 0;
+				this->filter_clear();
 			}
 		}
 
@@ -899,6 +1169,13 @@ namespace DiscordCoreAPI {
 		value_type_internal* data{};
 		size_type capacityVal{};
 		size_type sizeVal{};
+		int8_t currentMaxLookupDistance{ minimumLookups };
+		// slots emptied by erase since the last rebuild. while there are none, a key can't sit past the first empty slot
+		// of its probe window, so inserts can stop there.
+		size_type erasedSlots{};
+		float maxLoadFactor{ 0.90f };
+		float minLoadFactor{ 0.0f };
+		float growthFactor{ 2.0f };
 
 		inline static constexpr int8_t endValue{ -1 };
 
@@ -920,29 +1197,163 @@ namespace DiscordCoreAPI {
 			return std::max(int8_t{ 4 }, desired);
 		}
 
+		inline size_type capacityFor(size_type sizeNew) const {
+			return std::max(static_cast<size_type>(std::ceil(static_cast<double>(sizeNew) / maxLoadFactor)), size_type{ 4 });
+		}
+
+		inline size_type grownCapacity() const {
+			return static_cast<size_type>(static_cast<double>(capacityVal) * growthFactor) + 2;
+		}
+
 		inline void resize(size_type capacityNew) {
 			auto newSize = hash_policy::nextSizeOver(capacityNew);
 			if (newSize > capacityVal) {
-				auto oldPtr = data;
-				auto oldCapacity = capacityVal;
-				auto oldSize = sizeVal;
-				sizeVal = 0;
-				currentMaxLookupDistance = computeMaxLookupDistance(newSize + 1 + currentMaxLookupDistance);
-				data = allocator::allocate(newSize + 1 + currentMaxLookupDistance);
-				std::memset(data, 0, sizeof(value_type_internal) * (newSize + 1 + currentMaxLookupDistance));
-				capacityVal = newSize;
-				new (data + capacityVal) value_type_internal{ endValue };
-				auto currentPtr = oldPtr;
-				for (size_type x = 0; x < oldSize; ++currentPtr) {
-					if (currentPtr->areWeActive()) {
-						++x;
-						emplace(std::move(currentPtr->value.first), std::move(currentPtr->value.second));
+				rebuild(newSize);
+			}
+		}
+
+		inline void rebuild(size_type newSize) {
+			auto oldPtr = data;
+			auto oldCapacity = capacityVal;
+			auto oldSize = sizeVal;
+			auto oldMaxLookupDistance = currentMaxLookupDistance;
+			sizeVal = 0;
+			erasedSlots = 0;
+			currentMaxLookupDistance = computeMaxLookupDistance(newSize + 1 + currentMaxLookupDistance);
+			data = allocator::allocate(newSize + 1 + currentMaxLookupDistance);
+			std::memset(data, 0, sizeof(value_type_internal) * (newSize + 1 + currentMaxLookupDistance));
+			capacityVal = newSize;
+			hash_policy::commit(capacityVal);
+			this->filter_reset(static_cast<size_type>(static_cast<double>(capacityVal) * maxLoadFactor));
+			// the end marker goes after the probe overflow, which no probe reaches, so iteration sees the elements that
+			// spilled past capacityVal and never runs off the end of the allocation.
+			new (data + capacityVal + currentMaxLookupDistance) value_type_internal{ endValue };
+			auto currentPtr = oldPtr;
+			for (size_type x = 0; x < oldSize; ++currentPtr) {
+				if (currentPtr->areWeActive()) {
+					++x;
+					if constexpr (TriviallyRelocatableT<value_type>) {
+						relocate(currentPtr);
+					} else {
+						emplaceInternal(hashOf(*currentPtr), std::move(currentPtr->value.first), std::move(currentPtr->value.second));
+						currentPtr->disable();
 					}
 				}
-				if (oldPtr && oldCapacity) {
-					allocator::deallocate(oldPtr, oldCapacity + 1 + currentMaxLookupDistance);
+			}
+			if (oldPtr && oldCapacity) {
+				allocator::deallocate(oldPtr, oldCapacity + 1 + oldMaxLookupDistance);
+			}
+		}
+
+		inline const allocator& getAlloc() const {
+			return *this;
+		}
+
+		// with a polymorphic_allocator the key and value are built on the map's resource, so the strings they own
+		// land in the same arena as the slots themselves.
+		template<typename key_type_new, typename... Args> inline void enableEntry(pointer entry, key_type_new&& key, Args&&... value) {
+			if constexpr (PolymorphicAllocatorT<allocator>) {
+				entry->enable(std::make_obj_using_allocator<key_type>(getAlloc(), std::forward<key_type_new>(key)),
+					std::make_obj_using_allocator<mapped_type>(getAlloc(), std::forward<Args>(value)...));
+			} else {
+				entry->enable(std::forward<key_type_new>(key), std::forward<Args>(value)...);
+			}
+		}
+
+		// a replacement value for an existing key, on the map's resource for the same reason.
+		template<typename... Args> inline mapped_type makeMapped(Args&&... value) {
+			if constexpr (PolymorphicAllocatorT<allocator>) {
+				return std::make_obj_using_allocator<mapped_type>(getAlloc(), std::forward<Args>(value)...);
+			} else {
+				return mapped_type{ std::forward<Args>(value)... };
+			}
+		}
+
+		template<typename key_type_new, typename... Args> inline iterator emplaceInternal(uint64_t hash, key_type_new&& key, Args&&... value) {
+			if (capacityVal == 0) {
+				resize(capacityFor(sizeVal + 1));
+			}
+			pointer currentEntry = data + hash_policy::indexForHash(hash);
+			pointer emptyEntry{};
+			for (int8_t x{}; x < currentMaxLookupDistance; ++x, ++currentEntry) {
+				if (currentEntry->areWeActive()) {
+					if (currentEntry->hashMatches(hash) && object_compare()(currentEntry->value.first, key)) {
+						currentEntry->value.second = makeMapped(std::forward<Args>(value)...);
+						return currentEntry;
+					}
+				} else if (!emptyEntry) {
+					emptyEntry = currentEntry;
+					// an erase may have left this hole in front of the key, otherwise the key isn't in the map
+					if (erasedSlots == 0) {
+						break;
+					}
+				}
+			}
+			if (emptyEntry && static_cast<float>(sizeVal + 1) <= static_cast<float>(capacityVal) * maxLoadFactor) {
+				if (this->filter_needs_refill()) {
+					refillFilter();
+				}
+				this->filter_insert(hash);
+				enableEntry(emptyEntry, std::forward<key_type_new>(key), std::forward<Args>(value)...);
+				emptyEntry->setHash(hash);
+				sizeVal++;
+				return emptyEntry;
+			}
+			resize(grownCapacity());
+			return emplaceInternal(hash, std::forward<key_type_new>(key), std::forward<Args>(value)...);
+		}
+
+		// see detailv3::lookup_filter::filter_needs_refill().
+		inline void refillFilter() {
+			this->filter_refill_start();
+			for (size_type x = 0; x < capacityVal + currentMaxLookupDistance; ++x) {
+				if (data[x].areWeActive()) {
+					this->filter_refill_insert(hashOf(data[x]));
+				}
+			}
+		}
+
+		inline uint64_t hashOf(const value_type_internal& entry) const {
+			if constexpr (value_type_internal::storesHash) {
+				return entry.hash;
+			} else {
+				return key_hasher()(entry.value.first);
+			}
+		}
+
+		inline void relocate(pointer oldEntry) {
+			auto hash = hashOf(*oldEntry);
+			pointer currentEntry = data + hash_policy::indexForHash(hash);
+			for (int8_t x{}; x < currentMaxLookupDistance; ++x, ++currentEntry) {
+				if (currentEntry->areWeEmpty()) {
+					std::memcpy(static_cast<void*>(&currentEntry->value), static_cast<const void*>(&oldEntry->value), sizeof(value_type));
+					currentEntry->setHash(hash);
+					currentEntry->currentIndex = 1;
+					oldEntry->currentIndex = 0;
+					this->filter_insert(hash);
+					sizeVal++;
+					return;
 				}
 			}
+			emplaceInternal(hash, std::move(oldEntry->value.first), std::move(oldEntry->value.second));
+			oldEntry->disable();
+		}
+
+		inline void copySlots(const UnorderedMap& other) {
+			currentMaxLookupDistance = other.currentMaxLookupDistance;
+			data = allocator::allocate(other.capacityVal + 1 + currentMaxLookupDistance);
+			std::memcpy(static_cast<void*>(data), static_cast<const void*>(other.data), sizeof(value_type_internal) * (other.capacityVal + 1 + currentMaxLookupDistance));
+			capacityVal = other.capacityVal;
+			sizeVal = other.sizeVal;
+			erasedSlots = other.erasedSlots;
+			static_cast<hash_policy&>(*this) = other;
+			static_cast<lookup_filter&>(*this) = other;
 		}
 	};
+
+	template<typename KeyType, typename ValueType>
+	using PooledUnorderedMap = UnorderedMap<KeyType, ValueType, pooled_allocator<ObjectCore<Pair<KeyType, ValueType>>>>;
+
+	template<typename KeyType, typename ValueType>
+	using PmrUnorderedMap = UnorderedMap<KeyType, ValueType, std::pmr::polymorphic_allocator<ObjectCore<Pair<KeyType, ValueType>>>>;
 }
@@ -41,6 +41,1065 @@ template<typename TimeType, typename Function> void benchmark(Function function,
 	}std::cout << "Benchmark: " << benchmarkName << " Completed in: " << currentLowestTime << std::endl;
 }
 
+// with a void ResourceType the map keeps its default allocator and takes plain std::strings, which is the baseline the
+// memory resources are measured against.
+template<typename MapType, typename ResourceType> void pmrBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	auto withMap = [](auto&& test) {
+		if constexpr (std::is_void_v<ResourceType>) {
+			MapType map03{};
+			test(map03, [](const std::string& value) {
+				return value;
+			});
+		} else {
+			ResourceType resource{};
+			MapType map03{ typename MapType::allocator_type{ &resource } };
+			test(map03, [&](const std::string& value) {
+				return std::pmr::string{ value.data(), value.size(), &resource };
+			});
+		}
+	};
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Emplacing Test", [&] {
+		withMap([&](MapType& map03, auto&& makeString) {
+			for (uint64_t x = 0; x < 4096; ++x) {
+				auto newString = std::to_string(x);
+				map03.emplace(makeString(newString), makeString(newString));
+			}
+			for (auto iter = map03.begin(); iter != map03.end(); ++iter) {
+				result += strtoull(iter.operator->()->first.c_str(), nullptr, 10);
+			}
+		});
+	});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Erase Test", [&] {
+		withMap([&](MapType& map03, auto&& makeString) {
+			map03.reserve(2048);
+			for (uint64_t x = 0; x < 4096; ++x) {
+				auto newString = std::to_string(x);
+				map03.emplace(makeString(newString), makeString(newString));
+			}
+			for (auto iter = map03.begin(); iter != map03.end();) {
+				iter = map03.erase(iter);
+			}
+		});
+	});
+}
+
+template<typename MapType> void hashPolicyBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	MapType map{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		map.emplace(x << 16, x);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Poor Hash Emplacing Test", [&] {
+		MapType map03{};
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(x << 16, x);
+		}
+		result += map03.size();
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Poor Hash Find Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			result += map.find(x << 16)->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Poor Hash Find Miss Test", [&] {
+		for (uint64_t x = 4096; x < 8192; ++x) {
+			result += map.count(x << 16);
+		}
+	});
+}
+
+template<template<typename> class HashPolicyType> void unorderedMapPolicyBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	using MapType = DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, JsonifierInternal::AllocWrapper<DiscordCoreAPI::ObjectCore<DiscordCoreAPI::Pair<uint64_t, uint64_t>>>,
+		HashPolicyType>;
+	MapType map{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		map.emplace(x, x);
+	}
+	std::cout << benchmarkName << ", Capacity for 4096 entries: " << map.capacity() << std::endl;
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Emplacing Test", [&] {
+		MapType map03{};
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(x, x);
+		}
+		result += map03.size();
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			result += map.find(x)->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Miss Test", [&] {
+		for (uint64_t x = 4096; x < 8192; ++x) {
+			result += map.contains(x);
+		}
+	});
+}
+
+template<template<typename> class HashPolicyType> void loadFactorBenchmarks(float maxLoadFactor, int64_t& result) {
+	using MapType = DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, JsonifierInternal::AllocWrapper<DiscordCoreAPI::ObjectCore<DiscordCoreAPI::Pair<uint64_t, uint64_t>>>,
+		HashPolicyType>;
+	std::string benchmarkName{ "DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>, max_load_factor " + std::to_string(maxLoadFactor).substr(0, 4) };
+	MapType map{};
+	map.max_load_factor(maxLoadFactor);
+	map.reserve(4096);
+	for (uint64_t x = 0; x < 4096; ++x) {
+		map.emplace(x, x);
+	}
+	std::cout << benchmarkName << ", Capacity: " << map.capacity() << ", Load factor: " << map.load_factor() << ", Memory per entry: "
+			  << map.capacity() * sizeof(DiscordCoreAPI::ObjectCore<DiscordCoreAPI::Pair<uint64_t, uint64_t>>) / map.size() << " bytes" << std::endl;
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Emplacing Test", [&] {
+		MapType map03{};
+		map03.max_load_factor(maxLoadFactor);
+		map03.reserve(4096);
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(x, x);
+		}
+		result += map03.size();
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			result += map.find(x)->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Miss Test", [&] {
+		for (uint64_t x = 4096; x < 8192; ++x) {
+			result += map.contains(x);
+		}
+	});
+}
+
+// iteration over a map that has had 95% of its entries erased: left at peak capacity, shrunk as it went by
+// min_load_factor(), and compacted once at the end.
+template<typename MapType> void sweepAfterEraseBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	auto buildAndErase = [](float minLoadFactor) {
+		MapType map{};
+		map.min_load_factor(minLoadFactor);
+		for (uint64_t x = 0; x < 65536; ++x) {
+			map.emplace(x, x);
+		}
+		for (uint64_t x = 0; x < 65536 * 95 / 100; ++x) {
+			map.erase(x);
+		}
+		return map;
+	};
+	MapType peakMap{ buildAndErase(0.0f) };
+	MapType shrunkMap{ buildAndErase(0.1f) };
+	MapType compactedMap{ buildAndErase(0.0f) };
+	compactedMap.compact();
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Sweep After 95% Erase Test", [&] {
+		for (auto iter = peakMap.begin(); iter != peakMap.end(); ++iter) {
+			result += iter->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", min_load_factor 0.1, Sweep After 95% Erase Test", [&] {
+		for (auto iter = shrunkMap.begin(); iter != shrunkMap.end(); ++iter) {
+			result += iter->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", compact(), Sweep After 95% Erase Test", [&] {
+		for (auto iter = compactedMap.begin(); iter != compactedMap.end(); ++iter) {
+			result += iter->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(10).run(benchmarkName + ", min_load_factor 0.1, Erase 95% Test", [&] {
+		result += buildAndErase(0.1f).size();
+	});
+}
+
+// iteration over a table of 65536 slots with the given fraction of them in use, so the cost of stepping over empty slots
+// shows up next to the cost of visiting the live ones.
+template<typename MapType> void sparseIterationBenchmarks(const std::string& benchmarkName, float loadFactor, int64_t& result) {
+	MapType map{};
+	map.max_load_factor(0.95f);
+	map.rehash(65536);
+	for (uint64_t x = 0; x < static_cast<uint64_t>(65536 * loadFactor); ++x) {
+		map.emplace(x, x);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(
+		benchmarkName + ", load factor " + std::to_string(map.load_factor()).substr(0, 4) + ", Iteration Test", [&] {
+			for (auto iter = map.begin(); iter != map.end(); ++iter) {
+				result += iter->second;
+			}
+		});
+}
+
+// probes that only need the keys and a pass that only needs the values, over string keys and testStruct values.
+template<typename MapType> void layoutBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	MapType map{};
+	std::vector<std::string> hitKeys{};
+	std::vector<std::string> missKeys{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		testStruct value{ std::to_string(x) };
+		value.testInt = static_cast<int32_t>(x);
+		map.emplace(std::to_string(x), std::move(value));
+		hitKeys.emplace_back(std::to_string(x));
+		missKeys.emplace_back(std::to_string(x + 4096));
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Test", [&] {
+		for (auto& key: hitKeys) {
+			result += map.find(key) != map.end();
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Miss Test", [&] {
+		for (auto& key: missKeys) {
+			result += map.find(key) != map.end();
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Value Scan Test", [&] {
+		if constexpr (requires { map.sum_values(&testStruct::testInt); }) {
+			result += map.sum_values(&testStruct::testInt);
+		} else {
+			for (auto iter = map.begin(); iter != map.end(); ++iter) {
+				result += iter->second.testInt;
+			}
+		}
+	});
+}
+
+// a value of N bytes, for seeing at what size keeping values in nodes starts to pay off.
+template<size_t N> struct paddedValue {
+	uint64_t value;
+	char padding[N - sizeof(uint64_t)];
+};
+
+// building a table of 4096 entries from scratch, then looking up every key and walking every value.
+template<typename MapType> void valueSizeBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	ankerl::nanobench::Bench().epochs(10).epochIterations(10).run(benchmarkName + ", Insert Test", [&] {
+		MapType map{};
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map[x].value = x;
+		}
+		result += map.size();
+	});
+	MapType map{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		map[x].value = x;
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Find Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			result += map.find(x)->second.value;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run(benchmarkName + ", Iteration Test", [&] {
+		for (auto iter = map.begin(); iter != map.end(); ++iter) {
+			result += iter->second.value;
+		}
+	});
+}
+
+template<size_t N> void nodeStorageBenchmarks(int64_t& result) {
+	valueSizeBenchmarks<flat_hash_map<uint64_t, paddedValue<N>, inline_storage_std_hash<uint64_t>>>(
+		"flat_hash_map<uint64_t, " + std::to_string(N) + " byte value>, inline", result);
+	valueSizeBenchmarks<flat_hash_map<uint64_t, paddedValue<N>, node_storage_std_hash<uint64_t>>>(
+		"flat_hash_map<uint64_t, " + std::to_string(N) + " byte value>, node", result);
+}
+
+// the lifetime of a short lived map with a handful of entries: building it, looking up every key and throwing it away.
+template<typename MapType> void smallMapBenchmarks(const std::string& benchmarkName, uint64_t size, int64_t& result) {
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1000).run(benchmarkName + ", size " + std::to_string(size) + ", Construction Test", [&] {
+		MapType map{};
+		for (uint64_t x = 0; x < size; ++x) {
+			map.emplace(x * 0x9E3779B97F4A7C15ull, x);
+		}
+		result += map.size();
+	});
+	MapType map{};
+	for (uint64_t x = 0; x < size; ++x) {
+		map.emplace(x * 0x9E3779B97F4A7C15ull, x);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1000).run(benchmarkName + ", size " + std::to_string(size) + ", Find Test", [&] {
+		for (uint64_t x = size; x > 0; --x) {
+			result += map.find((x - 1) * 0x9E3779B97F4A7C15ull)->second;
+		}
+	});
+	// one map built up front for every iteration, so that each one times a single destructor and nothing else
+	std::vector<MapType> maps(10 * 1000);
+	for (auto& value: maps) {
+		for (uint64_t x = 0; x < size; ++x) {
+			value.emplace(x * 0x9E3779B97F4A7C15ull, x);
+		}
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1000).run(benchmarkName + ", size " + std::to_string(size) + ", Destruction Test", [&] {
+		if (!maps.empty()) {
+			maps.pop_back();
+		}
+	});
+}
+
+// gateway event names and their handlers, the way a bot dispatches them. each handler is a distinct function so that
+// the three dispatchers below can't be folded into one another.
+using gatewayHandler = uint64_t (*)(uint64_t);
+
+template<uint64_t Index> uint64_t gatewayHandlerFor(uint64_t value) {
+	return value * 31 + Index;
+}
+
+static constexpr std::pair<std::string_view, gatewayHandler> gatewayEvents[]{
+	{ "READY", &gatewayHandlerFor<0> },
+	{ "RESUMED", &gatewayHandlerFor<1> },
+	{ "APPLICATION_COMMAND_PERMISSIONS_UPDATE", &gatewayHandlerFor<2> },
+	{ "AUTO_MODERATION_RULE_CREATE", &gatewayHandlerFor<3> },
+	{ "AUTO_MODERATION_RULE_UPDATE", &gatewayHandlerFor<4> },
+	{ "AUTO_MODERATION_RULE_DELETE", &gatewayHandlerFor<5> },
+	{ "AUTO_MODERATION_ACTION_EXECUTION", &gatewayHandlerFor<6> },
+	{ "CHANNEL_CREATE", &gatewayHandlerFor<7> },
+	{ "CHANNEL_UPDATE", &gatewayHandlerFor<8> },
+	{ "CHANNEL_DELETE", &gatewayHandlerFor<9> },
+	{ "CHANNEL_PINS_UPDATE", &gatewayHandlerFor<10> },
+	{ "THREAD_CREATE", &gatewayHandlerFor<11> },
+	{ "THREAD_UPDATE", &gatewayHandlerFor<12> },
+	{ "THREAD_DELETE", &gatewayHandlerFor<13> },
+	{ "THREAD_LIST_SYNC", &gatewayHandlerFor<14> },
+	{ "THREAD_MEMBER_UPDATE", &gatewayHandlerFor<15> },
+	{ "THREAD_MEMBERS_UPDATE", &gatewayHandlerFor<16> },
+	{ "GUILD_CREATE", &gatewayHandlerFor<17> },
+	{ "GUILD_UPDATE", &gatewayHandlerFor<18> },
+	{ "GUILD_DELETE", &gatewayHandlerFor<19> },
+	{ "GUILD_BAN_ADD", &gatewayHandlerFor<20> },
+	{ "GUILD_BAN_REMOVE", &gatewayHandlerFor<21> },
+	{ "GUILD_EMOJIS_UPDATE", &gatewayHandlerFor<22> },
+	{ "GUILD_STICKERS_UPDATE", &gatewayHandlerFor<23> },
+	{ "GUILD_INTEGRATIONS_UPDATE", &gatewayHandlerFor<24> },
+	{ "GUILD_MEMBER_ADD", &gatewayHandlerFor<25> },
+	{ "GUILD_MEMBER_REMOVE", &gatewayHandlerFor<26> },
+	{ "GUILD_MEMBER_UPDATE", &gatewayHandlerFor<27> },
+	{ "GUILD_MEMBERS_CHUNK", &gatewayHandlerFor<28> },
+	{ "GUILD_ROLE_CREATE", &gatewayHandlerFor<29> },
+	{ "GUILD_ROLE_UPDATE", &gatewayHandlerFor<30> },
+	{ "GUILD_ROLE_DELETE", &gatewayHandlerFor<31> },
+	{ "GUILD_SCHEDULED_EVENT_CREATE", &gatewayHandlerFor<32> },
+	{ "GUILD_SCHEDULED_EVENT_UPDATE", &gatewayHandlerFor<33> },
+	{ "GUILD_SCHEDULED_EVENT_DELETE", &gatewayHandlerFor<34> },
+	{ "GUILD_SCHEDULED_EVENT_USER_ADD", &gatewayHandlerFor<35> },
+	{ "GUILD_SCHEDULED_EVENT_USER_REMOVE", &gatewayHandlerFor<36> },
+	{ "INTEGRATION_CREATE", &gatewayHandlerFor<37> },
+	{ "INTEGRATION_UPDATE", &gatewayHandlerFor<38> },
+	{ "INTEGRATION_DELETE", &gatewayHandlerFor<39> },
+	{ "INTERACTION_CREATE", &gatewayHandlerFor<40> },
+	{ "INVITE_CREATE", &gatewayHandlerFor<41> },
+	{ "INVITE_DELETE", &gatewayHandlerFor<42> },
+	{ "MESSAGE_CREATE", &gatewayHandlerFor<43> },
+	{ "MESSAGE_UPDATE", &gatewayHandlerFor<44> },
+	{ "MESSAGE_DELETE", &gatewayHandlerFor<45> },
+	{ "MESSAGE_DELETE_BULK", &gatewayHandlerFor<46> },
+	{ "MESSAGE_REACTION_ADD", &gatewayHandlerFor<47> },
+	{ "MESSAGE_REACTION_REMOVE", &gatewayHandlerFor<48> },
+	{ "MESSAGE_REACTION_REMOVE_ALL", &gatewayHandlerFor<49> },
+	{ "MESSAGE_REACTION_REMOVE_EMOJI", &gatewayHandlerFor<50> },
+	{ "PRESENCE_UPDATE", &gatewayHandlerFor<51> },
+	{ "STAGE_INSTANCE_CREATE", &gatewayHandlerFor<52> },
+	{ "STAGE_INSTANCE_UPDATE", &gatewayHandlerFor<53> },
+	{ "STAGE_INSTANCE_DELETE", &gatewayHandlerFor<54> },
+	{ "TYPING_START", &gatewayHandlerFor<55> },
+	{ "USER_UPDATE", &gatewayHandlerFor<56> },
+	{ "VOICE_STATE_UPDATE", &gatewayHandlerFor<57> },
+	{ "VOICE_SERVER_UPDATE", &gatewayHandlerFor<58> },
+	{ "WEBHOOKS_UPDATE", &gatewayHandlerFor<59> },
+};
+
+static constexpr auto frozenGatewayEvents = make_frozen_hash_map(gatewayEvents);
+
+// the hand written baseline: switch on the length, then compare against every name of that length.
+inline gatewayHandler switchGatewayEvent(std::string_view name) {
+	switch (name.size()) {
+		case 5:
+			if (name == "READY") {
+				return &gatewayHandlerFor<0>;
+			}
+			break;
+		case 7:
+			if (name == "RESUMED") {
+				return &gatewayHandlerFor<1>;
+			}
+			break;
+		case 11:
+			if (name == "USER_UPDATE") {
+				return &gatewayHandlerFor<56>;
+			}
+			break;
+		case 12:
+			if (name == "GUILD_CREATE") {
+				return &gatewayHandlerFor<17>;
+			}
+			if (name == "GUILD_UPDATE") {
+				return &gatewayHandlerFor<18>;
+			}
+			if (name == "GUILD_DELETE") {
+				return &gatewayHandlerFor<19>;
+			}
+			if (name == "TYPING_START") {
+				return &gatewayHandlerFor<55>;
+			}
+			break;
+		case 13:
+			if (name == "THREAD_CREATE") {
+				return &gatewayHandlerFor<11>;
+			}
+			if (name == "THREAD_UPDATE") {
+				return &gatewayHandlerFor<12>;
+			}
+			if (name == "THREAD_DELETE") {
+				return &gatewayHandlerFor<13>;
+			}
+			if (name == "GUILD_BAN_ADD") {
+				return &gatewayHandlerFor<20>;
+			}
+			if (name == "INVITE_CREATE") {
+				return &gatewayHandlerFor<41>;
+			}
+			if (name == "INVITE_DELETE") {
+				return &gatewayHandlerFor<42>;
+			}
+			break;
+		case 14:
+			if (name == "CHANNEL_CREATE") {
+				return &gatewayHandlerFor<7>;
+			}
+			if (name == "CHANNEL_UPDATE") {
+				return &gatewayHandlerFor<8>;
+			}
+			if (name == "CHANNEL_DELETE") {
+				return &gatewayHandlerFor<9>;
+			}
+			if (name == "MESSAGE_CREATE") {
+				return &gatewayHandlerFor<43>;
+			}
+			if (name == "MESSAGE_UPDATE") {
+				return &gatewayHandlerFor<44>;
+			}
+			if (name == "MESSAGE_DELETE") {
+				return &gatewayHandlerFor<45>;
+			}
+			break;
+		case 15:
+			if (name == "PRESENCE_UPDATE") {
+				return &gatewayHandlerFor<51>;
+			}
+			if (name == "WEBHOOKS_UPDATE") {
+				return &gatewayHandlerFor<59>;
+			}
+			break;
+		case 16:
+			if (name == "THREAD_LIST_SYNC") {
+				return &gatewayHandlerFor<14>;
+			}
+			if (name == "GUILD_BAN_REMOVE") {
+				return &gatewayHandlerFor<21>;
+			}
+			if (name == "GUILD_MEMBER_ADD") {
+				return &gatewayHandlerFor<25>;
+			}
+			break;
+		case 17:
+			if (name == "GUILD_ROLE_CREATE") {
+				return &gatewayHandlerFor<29>;
+			}
+			if (name == "GUILD_ROLE_UPDATE") {
+				return &gatewayHandlerFor<30>;
+			}
+			if (name == "GUILD_ROLE_DELETE") {
+				return &gatewayHandlerFor<31>;
+			}
+			break;
+		case 18:
+			if (name == "INTEGRATION_CREATE") {
+				return &gatewayHandlerFor<37>;
+			}
+			if (name == "INTEGRATION_UPDATE") {
+				return &gatewayHandlerFor<38>;
+			}
+			if (name == "INTEGRATION_DELETE") {
+				return &gatewayHandlerFor<39>;
+			}
+			if (name == "INTERACTION_CREATE") {
+				return &gatewayHandlerFor<40>;
+			}
+			if (name == "VOICE_STATE_UPDATE") {
+				return &gatewayHandlerFor<57>;
+			}
+			break;
+		case 19:
+			if (name == "CHANNEL_PINS_UPDATE") {
+				return &gatewayHandlerFor<10>;
+			}
+			if (name == "GUILD_EMOJIS_UPDATE") {
+				return &gatewayHandlerFor<22>;
+			}
+			if (name == "GUILD_MEMBER_REMOVE") {
+				return &gatewayHandlerFor<26>;
+			}
+			if (name == "GUILD_MEMBER_UPDATE") {
+				return &gatewayHandlerFor<27>;
+			}
+			if (name == "GUILD_MEMBERS_CHUNK") {
+				return &gatewayHandlerFor<28>;
+			}
+			if (name == "MESSAGE_DELETE_BULK") {
+				return &gatewayHandlerFor<46>;
+			}
+			if (name == "VOICE_SERVER_UPDATE") {
+				return &gatewayHandlerFor<58>;
+			}
+			break;
+		case 20:
+			if (name == "THREAD_MEMBER_UPDATE") {
+				return &gatewayHandlerFor<15>;
+			}
+			if (name == "MESSAGE_REACTION_ADD") {
+				return &gatewayHandlerFor<47>;
+			}
+			break;
+		case 21:
+			if (name == "THREAD_MEMBERS_UPDATE") {
+				return &gatewayHandlerFor<16>;
+			}
+			if (name == "GUILD_STICKERS_UPDATE") {
+				return &gatewayHandlerFor<23>;
+			}
+			if (name == "STAGE_INSTANCE_CREATE") {
+				return &gatewayHandlerFor<52>;
+			}
+			if (name == "STAGE_INSTANCE_UPDATE") {
+				return &gatewayHandlerFor<53>;
+			}
+			if (name == "STAGE_INSTANCE_DELETE") {
+				return &gatewayHandlerFor<54>;
+			}
+			break;
+		case 23:
+			if (name == "MESSAGE_REACTION_REMOVE") {
+				return &gatewayHandlerFor<48>;
+			}
+			break;
+		case 25:
+			if (name == "GUILD_INTEGRATIONS_UPDATE") {
+				return &gatewayHandlerFor<24>;
+			}
+			break;
+		case 27:
+			if (name == "AUTO_MODERATION_RULE_CREATE") {
+				return &gatewayHandlerFor<3>;
+			}
+			if (name == "AUTO_MODERATION_RULE_UPDATE") {
+				return &gatewayHandlerFor<4>;
+			}
+			if (name == "AUTO_MODERATION_RULE_DELETE") {
+				return &gatewayHandlerFor<5>;
+			}
+			if (name == "MESSAGE_REACTION_REMOVE_ALL") {
+				return &gatewayHandlerFor<49>;
+			}
+			break;
+		case 28:
+			if (name == "GUILD_SCHEDULED_EVENT_CREATE") {
+				return &gatewayHandlerFor<32>;
+			}
+			if (name == "GUILD_SCHEDULED_EVENT_UPDATE") {
+				return &gatewayHandlerFor<33>;
+			}
+			if (name == "GUILD_SCHEDULED_EVENT_DELETE") {
+				return &gatewayHandlerFor<34>;
+			}
+			break;
+		case 29:
+			if (name == "MESSAGE_REACTION_REMOVE_EMOJI") {
+				return &gatewayHandlerFor<50>;
+			}
+			break;
+		case 30:
+			if (name == "GUILD_SCHEDULED_EVENT_USER_ADD") {
+				return &gatewayHandlerFor<35>;
+			}
+			break;
+		case 32:
+			if (name == "AUTO_MODERATION_ACTION_EXECUTION") {
+				return &gatewayHandlerFor<6>;
+			}
+			break;
+		case 33:
+			if (name == "GUILD_SCHEDULED_EVENT_USER_REMOVE") {
+				return &gatewayHandlerFor<36>;
+			}
+			break;
+		case 38:
+			if (name == "APPLICATION_COMMAND_PERMISSIONS_UPDATE") {
+				return &gatewayHandlerFor<2>;
+			}
+			break;
+	}
+	return nullptr;
+}
+
+// freezing an id to shard index of a million entries, and looking every id up in the flat_hash_map and in the frozen copy.
+inline void perfectHashBenchmarks(int64_t& result) {
+	flat_hash_map<uint64_t, uint64_t> shardIndex{};
+	shardIndex.reserve(1 << 20);
+	for (uint64_t x = 0; x < (1 << 20); ++x) {
+		shardIndex.emplace(x * 0x9E3779B97F4A7C15ull, x % 64);
+	}
+	std::vector<uint64_t> lookupIds{};
+	for (uint64_t x = 0; x < (1 << 20); ++x) {
+		lookupIds.emplace_back(((x * 2654435761ull) % (1 << 20)) * 0x9E3779B97F4A7C15ull);
+	}
+	ankerl::nanobench::Bench().epochs(3).epochIterations(1).run("perfect_hash_map<uint64_t, uint64_t>, 2^20 keys, Freeze Test", [&] {
+		result += shardIndex.freeze().size();
+	});
+	auto frozenIndex = shardIndex.freeze();
+	std::cout << "perfect_hash_map<uint64_t, uint64_t>, 2^20 keys, Bits per key: " << frozenIndex.bits_per_key()
+			  << ", Memory per entry: " << frozenIndex.memory_usage() / frozenIndex.size() << " bytes" << std::endl;
+	ankerl::nanobench::Bench().epochs(10).epochIterations(10).run("flat_hash_map<uint64_t, uint64_t>, 2^20 keys, Find Test", [&] {
+		for (auto id: lookupIds) {
+			result += shardIndex.find(id)->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(10).run("perfect_hash_map<uint64_t, uint64_t>, 2^20 keys, Find Test", [&] {
+		for (auto id: lookupIds) {
+			result += frozenIndex.find(id)->second;
+		}
+	});
+}
+
+// 2^20 keys, looked up in a shuffled order where hitRate of the lookups are for keys that are in the map, so the
+// filtered tables can be compared against the plain ones from all misses to all hits.
+template<typename MapType> void negativeLookupBenchmarks(const std::string& benchmarkName, double hitRate, int64_t& result) {
+	static constexpr uint64_t keyCount{ 1 << 20 };
+	MapType map{};
+	for (uint64_t x = 0; x < keyCount; ++x) {
+		map.emplace(x * 0x9E3779B97F4A7C15ull, x);
+	}
+	std::vector<uint64_t> lookupKeys{};
+	std::mt19937_64 randomEngine{ keyCount };
+	std::bernoulli_distribution isHit{ hitRate };
+	for (uint64_t x = 0; x < keyCount; ++x) {
+		uint64_t key = (randomEngine() % keyCount) * 0x9E3779B97F4A7C15ull;
+		lookupKeys.emplace_back(isHit(randomEngine) ? key : key + 1);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1).run(benchmarkName + ", " + std::to_string(static_cast<int32_t>(hitRate * 100)) + "% hits, Find Test",
+		[&] {
+			for (auto key: lookupKeys) {
+				if constexpr (requires { map.contains(key); }) {
+					result += map.contains(key);
+				} else {
+					result += map.count(key);
+				}
+			}
+		});
+}
+
+// bytes held by a map's slots, for maps that don't report it themselves.
+template<typename MapType> size_t engineMemoryUsage(const MapType& map) {
+	if constexpr (requires { map.memory_usage(); }) {
+		return map.memory_usage();
+	} else if constexpr (requires { map.bucket_count(); }) {
+		size_t maxLookups = std::max<size_t>(4, std::bit_width(map.bucket_count()) - 1);
+		return (map.bucket_count() + maxLookups) * sizeof(detailv3::sherwood_v3_entry_for<typename MapType::value_type, typename MapType::hasher>);
+	} else {
+		return map.capacity() * sizeof(typename MapType::value_type_internal);
+	}
+}
+
+// the same 95% of 2^20 keys in every engine: just under the point where a table with 2^20 slots has to grow at a
+// max_load_factor of 0.95, which is where cuckoo_hash_map sits and the robin hood tables sit at half that.
+template<typename MapType> void engineBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	static constexpr uint64_t keyCount{ (1 << 20) * 95 / 100 };
+	MapType map{};
+	for (uint64_t x = 0; x < keyCount; ++x) {
+		map.emplace(x * 0x9E3779B97F4A7C15ull, x);
+	}
+	std::cout << benchmarkName << ", " << keyCount << " keys, Memory per entry: " << engineMemoryUsage(map) / map.size() << " bytes" << std::endl;
+	if constexpr (requires { map.probe_count_histogram(); }) {
+		std::cout << benchmarkName << ", " << keyCount << " keys, Key comparisons per hit:";
+		auto histogram = map.probe_count_histogram();
+		for (size_t x = 1; x < histogram.size(); ++x) {
+			std::cout << " " << x << ": " << histogram[x] << (x + 1 < histogram.size() ? "," : "");
+		}
+		std::cout << std::endl;
+	}
+	ankerl::nanobench::Bench().epochs(3).epochIterations(1).run(benchmarkName + ", " + std::to_string(keyCount) + " keys, Insert Test", [&] {
+		MapType map02{};
+		for (uint64_t x = 0; x < keyCount; ++x) {
+			map02.emplace(x * 0x9E3779B97F4A7C15ull, x);
+		}
+		result += map02.size();
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1).run(benchmarkName + ", " + std::to_string(keyCount) + " keys, Find Test", [&] {
+		for (uint64_t x = 0; x < keyCount; ++x) {
+			result += map.find(((x * 2654435761ull) % keyCount) * 0x9E3779B97F4A7C15ull)->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1).run(benchmarkName + ", " + std::to_string(keyCount) + " keys, Find Miss Test", [&] {
+		for (uint64_t x = 0; x < keyCount; ++x) {
+			if constexpr (requires { map.contains(x); }) {
+				result += map.contains(((x * 2654435761ull) % keyCount) * 0x9E3779B97F4A7C15ull + 1);
+			} else {
+				result += map.count(((x * 2654435761ull) % keyCount) * 0x9E3779B97F4A7C15ull + 1);
+			}
+		}
+	});
+}
+
+// 2^20 keys: a snapshot of the trie against a full copy of the flat tables, the same again followed by one write, which
+// is where the trie pays for its path copying, and lookups in each.
+template<typename MapType> void persistentMapBenchmarks(const std::string& benchmarkName, int64_t& result) {
+	static constexpr uint64_t keyCount{ 1 << 20 };
+	MapType map{};
+	for (uint64_t x = 0; x < keyCount; ++x) {
+		map.emplace(x * 0x9E3779B97F4A7C15ull, x);
+	}
+	auto takeSnapshot = [&] {
+		if constexpr (requires { map.snapshot(); }) {
+			return map.snapshot();
+		} else {
+			return MapType(map);
+		}
+	};
+	ankerl::nanobench::Bench().epochs(3).epochIterations(1).run(benchmarkName + ", " + std::to_string(keyCount) + " keys, Snapshot Test", [&] {
+		auto snapshot = takeSnapshot();
+		result += snapshot.size();
+	});
+	uint64_t writeCount{};
+	ankerl::nanobench::Bench().epochs(3).epochIterations(1).run(benchmarkName + ", " + std::to_string(keyCount) + " keys, Snapshot And Write Test", [&] {
+		auto snapshot = takeSnapshot();
+		++writeCount;
+		map.emplace((writeCount % keyCount) * 0x9E3779B97F4A7C15ull, writeCount);
+		result += snapshot.size();
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1).run(benchmarkName + ", " + std::to_string(keyCount) + " keys, Find Test", [&] {
+		for (uint64_t x = 0; x < keyCount; ++x) {
+			result += map.find(((x * 2654435761ull) % keyCount) * 0x9E3779B97F4A7C15ull)->second;
+		}
+	});
+}
+
+// times writeFunction over and over while a second thread runs exportFunction exportCount times, and prints the
+// latencies, since what a long export does to writers shows up in the tail rather than the mean.
+template<typename ExportFunction, typename WriteFunction>
+void writeLatencyDuringExport(const std::string& benchmarkName, ExportFunction&& exportFunction, WriteFunction&& writeFunction, int64_t& result) {
+	static constexpr uint64_t exportCount{ 16 };
+	std::atomic<uint64_t> exportsDone{};
+	std::atomic<int64_t> exported{};
+	std::thread exporter{ [&] {
+		for (uint64_t x = 0; x < exportCount; ++x) {
+			exported.fetch_add(exportFunction(), std::memory_order_relaxed);
+			exportsDone.fetch_add(1, std::memory_order_release);
+		}
+	} };
+	std::vector<int64_t> latencies{};
+	for (uint64_t x = 0; exportsDone.load(std::memory_order_acquire) < exportCount; ++x) {
+		auto start = std::chrono::steady_clock::now();
+		writeFunction(x);
+		latencies.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+	exporter.join();
+	result += exported.load();
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << benchmarkName << ", Write latency during export, p50: " << latencies[latencies.size() / 2] << " ns, p99: " << latencies[latencies.size() * 99 / 100]
+			  << " ns, max: " << latencies.back() << " ns" << std::endl;
+}
+
+// 2^20 keys exported by summing every value: a flat_hash_map whose export holds its lock for the whole scan, against a
+// ConcurrentMap whose export scans a snapshot.
+inline void concurrentMapBenchmarks(int64_t& result) {
+	static constexpr uint64_t keyCount{ 1 << 20 };
+	flat_hash_map<uint64_t, uint64_t> lockedMap{};
+	std::shared_mutex lockedMapMutex{};
+	DiscordCoreAPI::ConcurrentMap<uint64_t, uint64_t> concurrentMap{};
+	for (uint64_t x = 0; x < keyCount; ++x) {
+		lockedMap.emplace(x * 0x9E3779B97F4A7C15ull, x);
+		concurrentMap.emplace(x * 0x9E3779B97F4A7C15ull, x);
+	}
+	auto lockedExport = [&] {
+		std::shared_lock lock{ lockedMapMutex };
+		int64_t sum{};
+		for (auto& [key, value]: lockedMap) {
+			sum += value;
+		}
+		return sum;
+	};
+	auto snapshotExport = [&] {
+		auto snapshot = concurrentMap.snapshot();
+		int64_t sum{};
+		for (auto& [key, value]: snapshot) {
+			sum += value;
+		}
+		return sum;
+	};
+	ankerl::nanobench::Bench().epochs(3).epochIterations(1).run("flat_hash_map<uint64_t, uint64_t> and std::shared_mutex, 2^20 keys, Export Test", [&] {
+		result += lockedExport();
+	});
+	ankerl::nanobench::Bench().epochs(3).epochIterations(1).run("DiscordCoreAPI::ConcurrentMap<uint64_t, uint64_t>, 2^20 keys, Export Test", [&] {
+		result += snapshotExport();
+	});
+	// all the time that writers wait on a ConcurrentMap export, where the flat_hash_map one makes them wait out the whole scan.
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::ConcurrentMap<uint64_t, uint64_t>, 2^20 keys, Snapshot Test", [&] {
+		result += concurrentMap.snapshot().empty();
+	});
+	writeLatencyDuringExport("flat_hash_map<uint64_t, uint64_t> and std::shared_mutex, 2^20 keys", lockedExport,
+		[&](uint64_t x) {
+			std::unique_lock lock{ lockedMapMutex };
+			lockedMap.emplace((x % keyCount) * 0x9E3779B97F4A7C15ull, x);
+		},
+		result);
+	writeLatencyDuringExport("DiscordCoreAPI::ConcurrentMap<uint64_t, uint64_t>, 2^20 keys", snapshotExport,
+		[&](uint64_t x) {
+			concurrentMap.emplace((x % keyCount) * 0x9E3779B97F4A7C15ull, x);
+		},
+		result);
+}
+
+// the usual least recently used cache: a list of the entries in order of use, and a map from each key to its node.
+template<typename KeyType, typename ValueType> class ListLruCache {
+  public:
+	inline explicit ListLruCache(size_t capacityNew) : capacity{ capacityNew } {
+	}
+
+	inline ValueType* get(const KeyType& key) {
+		auto found = index.find(key);
+		if (found == index.end()) {
+			return nullptr;
+		}
+		entries.splice(entries.begin(), entries, found->second);
+		return &found->second->second;
+	}
+
+	inline bool put(const KeyType& key, const ValueType& value) {
+		auto [found, inserted] = index.try_emplace(key);
+		if (!inserted) {
+			found->second->second = value;
+			entries.splice(entries.begin(), entries, found->second);
+			return false;
+		}
+		entries.emplace_front(key, value);
+		found->second = entries.begin();
+		if (index.size() > capacity) {
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+		return true;
+	}
+
+  protected:
+	std::list<std::pair<KeyType, ValueType>> entries{};
+	std::unordered_map<KeyType, typename std::list<std::pair<KeyType, ValueType>>::iterator> index{};
+	size_t capacity{};
+};
+
+// length draws from keyCount keys, the one of rank r with probability proportional to 1 / r^exponent, scattered over the
+// key space so that popular keys aren't also neighbours.
+inline std::vector<uint64_t> zipfianTrace(uint64_t keyCount, double exponent, uint64_t length) {
+	std::vector<double> cumulativeWeights(keyCount);
+	double total{};
+	for (uint64_t x = 0; x < keyCount; ++x) {
+		total += 1.0 / std::pow(static_cast<double>(x + 1), exponent);
+		cumulativeWeights[x] = total;
+	}
+	std::mt19937_64 randomEngine{ keyCount };
+	std::uniform_real_distribution<double> draw{ 0.0, total };
+	std::vector<uint64_t> result{};
+	result.reserve(length);
+	for (uint64_t x = 0; x < length; ++x) {
+		auto rank = std::lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), draw(randomEngine)) - cumulativeWeights.begin();
+		result.emplace_back(static_cast<uint64_t>(std::min<int64_t>(rank, keyCount - 1)) * 0x9E3779B97F4A7C15ull);
+	}
+	return result;
+}
+
+// a read through cache: every access looks its key up and puts it on a miss. the hit rate comes from a first pass over
+// the trace, and the timed passes carry on with the cache that pass left behind.
+template<typename CacheType> void cacheBenchmarks(const std::string& benchmarkName, uint64_t capacity, const std::string& traceName,
+	const std::vector<uint64_t>& trace, int64_t& result) {
+	CacheType cache{ capacity };
+	auto replay = [&] {
+		uint64_t hits{};
+		for (auto key: trace) {
+			if (cache.get(key)) {
+				++hits;
+			} else {
+				cache.put(key, key);
+			}
+		}
+		return hits;
+	};
+	auto hits = replay();
+	std::cout << benchmarkName << ", capacity " << capacity << ", " << traceName << ", Hit rate: " << 100.0 * hits / trace.size() << "%" << std::endl;
+	ankerl::nanobench::Bench().epochs(10).epochIterations(1).run(benchmarkName + ", capacity " + std::to_string(capacity) + ", " + traceName + ", Replay Test",
+		[&] {
+			result += replay();
+		});
+}
+
+// a read through cache of values whose sizes vary by three orders of magnitude: key k's value is a string whose length
+// is drawn once per key from a distribution where big values are rare. one cache is held to a byte budget by
+// budgeted_clock_cache, the other to the entry count that budget would buy if every value had the mean size, which is how
+// a cache gets sized without a weigher. every 2^14 accesses the footprint of what each holds gets summed over all the
+// keys it could hold, and the largest of those is what the cache would have to be given, so that and the hit rate are
+// the things to compare.
+template<typename CacheType> void budgetBenchmarks(const std::string& benchmarkName, uint64_t capacity, uint64_t keyCount,
+	const std::vector<uint64_t>& trace, const std::vector<uint64_t>& valueSizes, int64_t& result) {
+	footprint_weigher<uint64_t, std::string> weigher{};
+	std::vector<uint64_t> keyFootprints(valueSizes.size());
+	for (uint64_t x = 0; x < valueSizes.size(); ++x) {
+		keyFootprints[x] = weigher(x, std::string(valueSizes[x], 'x'));
+	}
+	CacheType cache{ capacity };
+	uint64_t largestFootprint{};
+	uint64_t hits{};
+	for (uint64_t x = 0; x < trace.size(); ++x) {
+		if (auto value = cache.get(trace[x])) {
+			result += value->size();
+			++hits;
+		} else {
+			cache.put(trace[x], std::string(valueSizes[trace[x] % valueSizes.size()], 'x'));
+		}
+		if (x % (1 << 14) == 0) {
+			uint64_t footprint{};
+			for (uint64_t y = 0; y < keyCount; ++y) {
+				uint64_t key = y * 0x9E3779B97F4A7C15ull;
+				if (cache.contains(key)) {
+					footprint += keyFootprints[key % valueSizes.size()];
+				}
+			}
+			largestFootprint = std::max(largestFootprint, footprint);
+		}
+	}
+	std::cout << benchmarkName << ", capacity " << capacity << ", Hit rate: " << 100.0 * hits / trace.size()
+			  << "%, largest footprint: " << largestFootprint / (1024 * 1024) << " MiB" << std::endl;
+}
+
+// shrink_to_fit() on a table that ran at a high load factor and then lost half its keys moves every survivor into a
+// smaller slot array, where a probe sequence can run out and send the element being carried back through emplace().
+// throws if that loses a key, since nothing would be worth timing after it.
+inline void shrinkAfterEraseTest(int64_t& result) {
+	std::mt19937_64 randomEngine{ 1 };
+	for (uint64_t trial = 0; trial < 100000; ++trial) {
+		flat_hash_map<uint64_t, uint64_t, power_of_two_std_hash<uint64_t>> map{};
+		map.max_load_factor(0.95f);
+		std::vector<uint64_t> keys(8 + randomEngine() % 193);
+		for (auto& key: keys) {
+			key = randomEngine();
+			map.emplace(key, key);
+		}
+		for (size_t x = 0; x < keys.size(); x += 2) {
+			map.erase(keys[x]);
+		}
+		map.shrink_to_fit();
+		for (size_t x = 1; x < keys.size(); x += 2) {
+			if (map.find(keys[x]) == map.end()) {
+				throw std::runtime_error{ "flat_hash_map<uint64_t, uint64_t> lost a key to shrink_to_fit()." };
+			}
+		}
+		result += map.size();
+	}
+}
+
+// erase() through an iterator has to take the iterator of the map it's called on, template arguments and all, which
+// for a map that stores its hashes isn't the default map's iterator.
+inline void storedHashEraseTest(int64_t& result) {
+	DiscordCoreAPI::UnorderedMap<std::string, uint64_t, JsonifierInternal::AllocWrapper<DiscordCoreAPI::ObjectCore<DiscordCoreAPI::Pair<std::string, uint64_t>>>,
+		DiscordCoreAPI::HashPolicy, false, true>
+		map{};
+	for (uint64_t x = 0; x < 1000; ++x) {
+		map.emplace(std::to_string(x) + " is a key long enough to live on the heap", x);
+	}
+	for (uint64_t x = 0; x < 1000; x += 2) {
+		map.erase(map.find(std::to_string(x) + " is a key long enough to live on the heap"));
+	}
+	for (uint64_t x = 0; x < 1000; ++x) {
+		if (map.contains(std::to_string(x) + " is a key long enough to live on the heap") != (x % 2 == 1)) {
+			throw std::runtime_error{ "UnorderedMap<std::string, uint64_t, StoreHash> erased the wrong keys through an iterator." };
+		}
+	}
+	result += map.size();
+}
+
+// emplacing a key that's already there assigns over its value, which for a std::string means the old buffer has to
+// still be alive when the new one goes in. run before the expiry benchmarks, and throws rather than timing a broken map.
+inline void reemplaceTest(int64_t& result) {
+	auto valueFor = [](uint64_t x, uint64_t round) {
+		return std::to_string(x) + " is a value long enough to live on the heap, round " + std::to_string(round);
+	};
+	DiscordCoreAPI::ExpiringUnorderedMap<uint64_t, std::string> map{};
+	for (uint64_t round = 0; round < 3; ++round) {
+		for (uint64_t x = 0; x < 1000; ++x) {
+			map.emplaceWithTtl(x, 1000 + x, valueFor(x, round));
+		}
+	}
+	for (uint64_t x = 0; x < 1000; ++x) {
+		auto value = map.find(x);
+		if (!value || *value != valueFor(x, 2)) {
+			throw std::runtime_error{ "ExpiringUnorderedMap<uint64_t, std::string> lost a re-emplaced value." };
+		}
+		result += value->size();
+	}
+}
+
+// 10 million entries on a millisecond clock, a quarter each with time to lives of between 1 and 2, 10 and 20, 60 and 120
+// and 600 and 1200 seconds, ticked until they've all expired: once dropped by ExpiringUnorderedMap's timing wheel every
+// second, and once by a sweep over an UnorderedMap of deadlines every 20 seconds, the way it's done without one, since a
+// sweep every second would cost more than a second. each tick stalls its thread for as long as it runs, so the longest
+// one matters as much as the total.
+inline void expiryBenchmarks(int64_t& result) {
+	static constexpr uint64_t entryCount{ 10000000 };
+	static constexpr uint64_t timesToLive[]{ 1000, 10000, 60000, 600000 };
+	auto timeTicks = [&](const std::string& benchmarkName, uint64_t tickInterval, auto&& tick) {
+		int64_t total{};
+		int64_t longest{};
+		for (uint64_t now = tickInterval; now <= 2 * timesToLive[3]; now += tickInterval) {
+			auto start = std::chrono::steady_clock::now();
+			tick(now);
+			auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			total += elapsed;
+			longest = std::max(longest, elapsed);
+		}
+		std::cout << benchmarkName << ", 10M entries, mixed TTLs, Expiry over " << 2 * timesToLive[3] / tickInterval << " ticks, total: " << total / 1000
+				  << " ms, longest tick: " << longest / 1000 << " ms" << std::endl;
+	};
+	auto timeToLive = [](uint64_t x) {
+		return timesToLive[x % 4] + (x / 4) % timesToLive[x % 4];
+	};
+	{
+		DiscordCoreAPI::ExpiringUnorderedMap<uint64_t, uint64_t> map{};
+		for (uint64_t x = 0; x < entryCount; ++x) {
+			map.emplaceWithTtl(x * 0x9E3779B97F4A7C15ull, timeToLive(x), x);
+		}
+		timeTicks("DiscordCoreAPI::ExpiringUnorderedMap<uint64_t, uint64_t>", 1000, [&](uint64_t now) {
+			result += map.tick(now);
+		});
+		result += map.size();
+	}
+	{
+		DiscordCoreAPI::UnorderedMap<uint64_t, DiscordCoreAPI::ExpiringValue<uint64_t>> map{};
+		for (uint64_t x = 0; x < entryCount; ++x) {
+			map.emplace(x * 0x9E3779B97F4A7C15ull, DiscordCoreAPI::ExpiringValue<uint64_t>{ x, timeToLive(x) });
+		}
+		timeTicks("DiscordCoreAPI::UnorderedMap<uint64_t, ExpiringValue<uint64_t>> and a full sweep", 20000, [&](uint64_t now) {
+			for (auto iterator = map.begin(); iterator != map.end();) {
+				if (iterator->second.expiresAt <= now) {
+					iterator = map.erase(iterator);
+					++result;
+				} else {
+					++iterator;
+				}
+			}
+		});
+		result += map.size();
+	}
+}
+
+// slot array plus whatever the std::string keys keep on the heap past their small buffer.
+template<typename ValueType, typename HashType> size_t memoryUsage(const flat_hash_map<std::string, ValueType, HashType>& map) {
+	size_t maxLookups = std::max<size_t>(4, std::bit_width(map.bucket_count()) - 1);
+	size_t result = (map.bucket_count() + maxLookups) *
+		sizeof(detailv3::sherwood_v3_entry_for<std::pair<std::string, ValueType>, HashType>);
+	for (auto& [key, value]: map) {
+		if (key.capacity() > std::string{}.capacity()) {
+			result += key.capacity() + 1;
+		}
+	}
+	return result;
+}
+
 static constexpr int8_t maxProbingDistance{ 4 };
 /*
 template<typename ValueTypeInternal, typename ValueType> class CoreIterator {
@@ -449,6 +1508,25 @@ int main() {
 			iter = map03.erase(iter);
 		}});
 
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("dense_hash_map<uint64_t, testStruct>, AIO Test", [&] {
+		dense_hash_map<std::string, testStruct> map03{};
+		map03.reserve(2048);
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(std::to_string(x), testStruct{ std::to_string(x) });
+		}
+		for (auto iter = map03.begin(); iter != map03.end(); ++iter) {
+			result += stoull(iter.operator->()->first);
+		}
+		for (auto iter = map03.begin(); iter != map03.end(); ++iter) {
+			result += stoull(iter.operator->()->first);
+		}
+		for (auto iter = map03.begin(); iter != map03.end(); ++iter) {
+			result += stoull(map03.find(iter.operator*().first).operator*().second.operator std::string & ());
+		}
+		for (auto iter = map03.begin(); iter != map03.end();) {
+			iter = map03.erase(iter);
+		}});
+
 	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<uint64_t, testStruct>, Reserve Test", [&] {
 		flat_hash_map<std::string, testStruct> map03{};
 		map03.reserve(2048);
@@ -507,6 +1585,370 @@ int main() {
 		}
 		});
 
+	flat_hash_map<uint64_t, uint64_t> idMap01{};
+	DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t> idMap02{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		idMap01.emplace(x, x);
+		idMap02.emplace(x, x);
+	}
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<uint64_t, uint64_t>, Copy Test", [&] {
+		flat_hash_map<uint64_t, uint64_t> map03{ idMap01 };
+		result += map03.size();
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<uint64_t, uint64_t>, Rehash Test", [&] {
+		flat_hash_map<uint64_t, uint64_t> map03{};
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(x, x);
+		}
+		result += map03.size();
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>, Copy Test", [&] {
+		DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t> map03{ idMap02 };
+		result += map03.size();
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>, Rehash Test", [&] {
+		DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t> map03{};
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(x, x);
+		}
+		result += map03.size();
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("pooled_flat_hash_map<std::string, testStruct>, Reserve Test", [&] {
+		pooled_flat_hash_map<std::string, testStruct> map03{};
+		map03.reserve(2048);
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::PooledUnorderedMap<std::string, testStruct>, Reserve Test", [&] {
+		DiscordCoreAPI::PooledUnorderedMap<std::string, testStruct> map03{};
+		map03.reserve(2048);
+		});
+
+	DiscordCoreAPI::UnorderedMap<std::string, testStruct> reusedMap{};
+	reusedMap.reserve(2048);
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::UnorderedMap<std::string, testStruct>, Reset Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			reusedMap.emplace(std::to_string(x), testStruct{ std::to_string(x) });
+		}
+		for (auto iter = reusedMap.begin(); iter != reusedMap.end(); ++iter) {
+			result += stoull(iter.operator->()->first);
+		}
+		reusedMap.reset();
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("string_arena_map<testStruct>, Find Test", [&] {
+		string_arena_map<testStruct> map03{};
+		map03.reserve(2048);
+		for (uint64_t x = 0; x < 4096; ++x) {
+			map03.emplace(std::to_string(x), testStruct{ std::to_string(x) });
+		}
+		for (auto iter = map03.begin(); iter != map03.end(); ++iter) {
+			result += stoull(map03.find(iter.operator*().first).operator*().second.operator std::string & ());
+		}
+		});
+
+	std::vector<std::string> longKeys{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		longKeys.emplace_back("guild_member:" + std::to_string(x * 7919) + ":" + std::to_string(x));
+	}
+	flat_hash_map<std::string, uint64_t> stringMap{};
+	string_arena_map<uint64_t> arenaMap{};
+	for (uint64_t x = 0; x < longKeys.size(); ++x) {
+		stringMap.emplace(longKeys[x], x);
+		arenaMap.emplace(longKeys[x], x);
+	}
+	std::cout << "flat_hash_map<std::string, uint64_t>, Memory per entry: " << memoryUsage(stringMap) / stringMap.size() << " bytes" << std::endl;
+	std::cout << "string_arena_map<uint64_t>, Memory per entry: " << arenaMap.memory_usage() / arenaMap.size() << " bytes" << std::endl;
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, uint64_t>, Long Key Find Test", [&] {
+		for (auto& key: longKeys) {
+			result += stringMap.find(key)->second;
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("string_arena_map<uint64_t>, Long Key Find Test", [&] {
+		for (auto& key: longKeys) {
+			result += arenaMap.find(key)->second;
+		}
+		});
+
+	// same keys with the hash kept in every slot. the misses share the hits' prefix, so without the stored hash
+	// every probe ends up running memcmp over it
+	std::vector<std::string> missingKeys{};
+	for (uint64_t x = 0; x < longKeys.size(); ++x) {
+		missingKeys.emplace_back("guild_member:" + std::to_string(x * 7919) + ":" + std::to_string(x + longKeys.size()));
+	}
+	flat_hash_map<std::string, uint64_t, store_hash_std_hash<std::string>> storedHashMap{};
+	DiscordCoreAPI::UnorderedMap<std::string, uint64_t> unstoredHashMap02{};
+	DiscordCoreAPI::UnorderedMap<std::string, uint64_t, JsonifierInternal::AllocWrapper<DiscordCoreAPI::ObjectCore<DiscordCoreAPI::Pair<std::string, uint64_t>>>,
+		DiscordCoreAPI::HashPolicy, false, true>
+		storedHashMap02{};
+	for (uint64_t x = 0; x < longKeys.size(); ++x) {
+		storedHashMap.emplace(longKeys[x], x);
+		unstoredHashMap02.emplace(longKeys[x], x);
+		storedHashMap02.emplace(longKeys[x], x);
+	}
+	std::cout << "flat_hash_map<std::string, uint64_t, store_hash_std_hash>, Memory per entry: " << memoryUsage(storedHashMap) / storedHashMap.size()
+			  << " bytes" << std::endl;
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, uint64_t, store_hash_std_hash>, Long Key Find Test", [&] {
+		for (auto& key: longKeys) {
+			result += storedHashMap.find(key)->second;
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, uint64_t>, Long Key Miss Test", [&] {
+		for (auto& key: missingKeys) {
+			result += stringMap.count(key);
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, uint64_t, store_hash_std_hash>, Long Key Miss Test", [&] {
+		for (auto& key: missingKeys) {
+			result += storedHashMap.count(key);
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::UnorderedMap<std::string, uint64_t>, Long Key Miss Test", [&] {
+		for (auto& key: missingKeys) {
+			result += unstoredHashMap02.contains(key);
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("DiscordCoreAPI::UnorderedMap<std::string, uint64_t, StoreHash>, Long Key Miss Test", [&] {
+		for (auto& key: missingKeys) {
+			result += storedHashMap02.contains(key);
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, uint64_t>, Long Key Grow Test", [&] {
+		flat_hash_map<std::string, uint64_t> map03{};
+		for (uint64_t x = 0; x < longKeys.size(); ++x) {
+			map03.emplace(longKeys[x], x);
+		}
+		result += map03.size();
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, uint64_t, store_hash_std_hash>, Long Key Grow Test", [&] {
+		flat_hash_map<std::string, uint64_t, store_hash_std_hash<std::string>> map03{};
+		for (uint64_t x = 0; x < longKeys.size(); ++x) {
+			map03.emplace(longKeys[x], x);
+		}
+		result += map03.size();
+		});
+
+	split_flat_hash_map<uint64_t, uint64_t> splitMap{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		splitMap.emplace(x, x);
+	}
+	size_t idMapLookups = std::max<size_t>(4, std::bit_width(idMap01.bucket_count()) - 1);
+	std::cout << "flat_hash_map<uint64_t, uint64_t>, Memory per entry: "
+			  << (idMap01.bucket_count() + idMapLookups) * sizeof(detailv3::sherwood_v3_entry<std::pair<uint64_t, uint64_t>>) / idMap01.size() << " bytes"
+			  << std::endl;
+	std::cout << "split_flat_hash_map<uint64_t, uint64_t>, Memory per entry: " << splitMap.memory_usage() / splitMap.size() << " bytes" << std::endl;
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<uint64_t, uint64_t>, Find Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			result += idMap01.find(x)->second;
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("split_flat_hash_map<uint64_t, uint64_t>, Find Test", [&] {
+		for (uint64_t x = 0; x < 4096; ++x) {
+			result += splitMap.find(x)->second;
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<uint64_t, uint64_t>, Find Miss Test", [&] {
+		for (uint64_t x = 4096; x < 8192; ++x) {
+			result += idMap01.count(x);
+		}
+		});
+
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("split_flat_hash_map<uint64_t, uint64_t>, Find Miss Test", [&] {
+		for (uint64_t x = 4096; x < 8192; ++x) {
+			result += splitMap.count(x);
+		}
+		});
+
+	// std::hash<uint64_t> is the identity, so keys that only differ above bit 16 are about as badly spread as hashes get
+	hashPolicyBenchmarks<flat_hash_map<uint64_t, uint64_t, prime_number_std_hash<uint64_t>>>("flat_hash_map<uint64_t, uint64_t, prime_number_std_hash>", result);
+	hashPolicyBenchmarks<flat_hash_map<uint64_t, uint64_t, fastmod_prime_std_hash<uint64_t>>>("flat_hash_map<uint64_t, uint64_t, fastmod_prime_std_hash>", result);
+	hashPolicyBenchmarks<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map<uint64_t, uint64_t>", result);
+
+	unorderedMapPolicyBenchmarks<DiscordCoreAPI::HashPolicy>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, HashPolicy>", result);
+	unorderedMapPolicyBenchmarks<DiscordCoreAPI::PowerOfTwoHashPolicy>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, PowerOfTwoHashPolicy>", result);
+	unorderedMapPolicyBenchmarks<DiscordCoreAPI::FibonacciHashPolicy>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, FibonacciHashPolicy>", result);
+	unorderedMapPolicyBenchmarks<DiscordCoreAPI::PrimeHashPolicy>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, PrimeHashPolicy>", result);
+	unorderedMapPolicyBenchmarks<DiscordCoreAPI::FastRangeHashPolicy>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t, FastRangeHashPolicy>", result);
+
+	for (float maxLoadFactor = 0.5f; maxLoadFactor < 0.951f; maxLoadFactor += 0.05f) {
+		loadFactorBenchmarks<DiscordCoreAPI::FastRangeHashPolicy>(maxLoadFactor, result);
+	}
+
+	sweepAfterEraseBenchmarks<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map<uint64_t, uint64_t>", result);
+	sweepAfterEraseBenchmarks<DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>", result);
+
+	string_arena_map<uint64_t> erasedArenaMap{};
+	for (uint64_t x = 0; x < longKeys.size(); ++x) {
+		erasedArenaMap.emplace(longKeys[x], x);
+	}
+	for (uint64_t x = 0; x < longKeys.size() * 95 / 100; ++x) {
+		erasedArenaMap.erase(longKeys[x]);
+	}
+	std::cout << "string_arena_map<uint64_t>, after erasing 95%: " << erasedArenaMap.memory_usage() << " bytes, ";
+	erasedArenaMap.compact();
+	std::cout << "after compact(): " << erasedArenaMap.memory_usage() << " bytes" << std::endl;
+
+	for (float loadFactor: { 0.05f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f }) {
+		sparseIterationBenchmarks<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map<uint64_t, uint64_t>", loadFactor, result);
+		sparseIterationBenchmarks<flat_hash_map<uint64_t, uint64_t, occupancy_bitmap_std_hash<uint64_t>>>(
+			"flat_hash_map<uint64_t, uint64_t, occupancy_bitmap_std_hash>", loadFactor, result);
+		sparseIterationBenchmarks<split_flat_hash_map<uint64_t, uint64_t>>("split_flat_hash_map<uint64_t, uint64_t>", loadFactor, result);
+	}
+
+	layoutBenchmarks<flat_hash_map<std::string, testStruct>>("flat_hash_map<std::string, testStruct>", result);
+	layoutBenchmarks<split_flat_hash_map<std::string, testStruct>>("split_flat_hash_map<std::string, testStruct>", result);
+	layoutBenchmarks<soa_flat_hash_map<std::string, testStruct>>("soa_flat_hash_map<std::string, testStruct>", result);
+
+	soa_flat_hash_map<uint64_t, uint64_t> soaIdMap{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		soaIdMap.emplace(x, x);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<uint64_t, uint64_t>, Value Sum Test", [&] {
+		for (auto iter = idMap01.begin(); iter != idMap01.end(); ++iter) {
+			result += iter->second;
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("soa_flat_hash_map<uint64_t, uint64_t>, Value Sum Test", [&] {
+		result += soaIdMap.sum_values();
+	});
+
+	std::vector<std::string> gatewayTrace{};
+	for (uint64_t x = 0; x < 4096; ++x) {
+		gatewayTrace.emplace_back(gatewayEvents[(x * x + x * 7) % std::size(gatewayEvents)].first);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, gatewayHandler>, Startup Construction Test", [&] {
+		flat_hash_map<std::string, gatewayHandler> handlers{};
+		for (auto& [name, handler]: gatewayEvents) {
+			handlers.emplace(std::string{ name }, handler);
+		}
+		result += handlers.size();
+	});
+	flat_hash_map<std::string, gatewayHandler> gatewayHandlers{};
+	for (auto& [name, handler]: gatewayEvents) {
+		gatewayHandlers.emplace(std::string{ name }, handler);
+	}
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("flat_hash_map<std::string, gatewayHandler>, Dispatch Test", [&] {
+		for (auto& name: gatewayTrace) {
+			result += gatewayHandlers.find(name)->second(static_cast<uint64_t>(result));
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("frozen_hash_map<std::string_view, gatewayHandler>, Dispatch Test", [&] {
+		for (auto& name: gatewayTrace) {
+			result += frozenGatewayEvents.find(name)->second(static_cast<uint64_t>(result));
+		}
+	});
+	ankerl::nanobench::Bench().epochs(10).epochIterations(100).run("switch on std::string_view, Dispatch Test", [&] {
+		for (auto& name: gatewayTrace) {
+			result += switchGatewayEvent(name)(static_cast<uint64_t>(result));
+		}
+	});
+
+	persistentMapBenchmarks<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map<uint64_t, uint64_t>", result);
+	persistentMapBenchmarks<DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>", result);
+	persistentMapBenchmarks<DiscordCoreAPI::PersistentMap<uint64_t, uint64_t>>("DiscordCoreAPI::PersistentMap<uint64_t, uint64_t>", result);
+
+	concurrentMapBenchmarks(result);
+
+	for (double exponent: { 0.8, 0.99 }) {
+		std::string traceName{ "2^20 accesses to 2^20 keys, zipf " + std::to_string(exponent).substr(0, 4) };
+		auto trace = zipfianTrace(1 << 20, exponent, 1 << 20);
+		for (uint64_t capacity: { 1 << 12, 1 << 16 }) {
+			cacheBenchmarks<clock_cache<uint64_t, uint64_t>>("clock_cache<uint64_t, uint64_t>", capacity, traceName, trace, result);
+			cacheBenchmarks<ListLruCache<uint64_t, uint64_t>>("std::list and std::unordered_map LRU", capacity, traceName, trace, result);
+		}
+	}
+
+	{
+		// lengths from 16 bytes to 64 KiB, log-uniform so that each doubling is as likely as the next, for a mean footprint
+		// of about 8 KiB, and a 64 MiB budget
+		static constexpr uint64_t budget{ 64 * 1024 * 1024 };
+		std::mt19937_64 randomEngine{ 4093 };
+		std::uniform_real_distribution<double> exponent{ 4.0, 16.0 };
+		std::vector<uint64_t> valueSizes(4093);
+		footprint_weigher<uint64_t, std::string> weigher{};
+		uint64_t meanFootprint{};
+		uint64_t largestFootprint{};
+		for (auto& size: valueSizes) {
+			size = static_cast<uint64_t>(std::exp2(exponent(randomEngine)));
+			uint64_t footprint = weigher(0, std::string(size, 'x'));
+			meanFootprint += footprint;
+			largestFootprint = std::max(largestFootprint, footprint);
+		}
+		meanFootprint /= valueSizes.size();
+		auto trace = zipfianTrace(1 << 20, 0.99, 1 << 20);
+		budgetBenchmarks<budgeted_clock_cache<uint64_t, std::string>>("budgeted_clock_cache<uint64_t, std::string>", budget, 1 << 20, trace,
+			valueSizes, result);
+		// the only entry count that's sure to stay under budget, and the one that fits it on average
+		budgetBenchmarks<clock_cache<uint64_t, std::string>>("clock_cache<uint64_t, std::string>, sized for the largest value", budget / largestFootprint,
+			1 << 20, trace, valueSizes, result);
+		budgetBenchmarks<clock_cache<uint64_t, std::string>>("clock_cache<uint64_t, std::string>, sized for the mean value", budget / meanFootprint,
+			1 << 20, trace, valueSizes, result);
+	}
+
+	shrinkAfterEraseTest(result);
+	storedHashEraseTest(result);
+	reemplaceTest(result);
+	expiryBenchmarks(result);
+
+	engineBenchmarks<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map<uint64_t, uint64_t>", result);
+	engineBenchmarks<split_flat_hash_map<uint64_t, uint64_t>>("split_flat_hash_map<uint64_t, uint64_t>", result);
+	engineBenchmarks<dense_hash_map<uint64_t, uint64_t>>("dense_hash_map<uint64_t, uint64_t>", result);
+	engineBenchmarks<DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>", result);
+	engineBenchmarks<cuckoo_hash_map<uint64_t, uint64_t>>("cuckoo_hash_map<uint64_t, uint64_t>, 4 slots per bucket", result);
+	engineBenchmarks<cuckoo_hash_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>, std::allocator<std::pair<uint64_t, uint64_t>>, 8>>(
+		"cuckoo_hash_map<uint64_t, uint64_t>, 8 slots per bucket", result);
+	engineBenchmarks<hopscotch_hash_map<uint64_t, uint64_t>>("hopscotch_hash_map<uint64_t, uint64_t>, 32 slot neighborhoods", result);
+	engineBenchmarks<hopscotch_hash_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>, std::allocator<std::pair<uint64_t, uint64_t>>, 64>>(
+		"hopscotch_hash_map<uint64_t, uint64_t>, 64 slot neighborhoods", result);
+
+	for (double hitRate: { 0.0, 0.3, 0.7, 1.0 }) {
+		negativeLookupBenchmarks<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map<uint64_t, uint64_t>", hitRate, result);
+		negativeLookupBenchmarks<flat_hash_map<uint64_t, uint64_t, negative_filter_std_hash<uint64_t>>>(
+			"flat_hash_map<uint64_t, uint64_t, negative_filter_std_hash<uint64_t>>", hitRate, result);
+		negativeLookupBenchmarks<DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>", hitRate, result);
+		negativeLookupBenchmarks<DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t,
+			JsonifierInternal::AllocWrapper<DiscordCoreAPI::ObjectCore<DiscordCoreAPI::Pair<uint64_t, uint64_t>>>, DiscordCoreAPI::HashPolicy, true>>(
+			"DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>, NegativeLookupFilter", hitRate, result);
+	}
+
+	perfectHashBenchmarks(result);
+
+	for (uint64_t size: { 0, 1, 2, 4, 8, 16, 32 }) {
+		smallMapBenchmarks<DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>>("DiscordCoreAPI::UnorderedMap<uint64_t, uint64_t>", size, result);
+		smallMapBenchmarks<DiscordCoreAPI::SmallUnorderedMap<uint64_t, uint64_t>>("DiscordCoreAPI::SmallUnorderedMap<uint64_t, uint64_t>", size, result);
+	}
+
+	nodeStorageBenchmarks<16>(result);
+	nodeStorageBenchmarks<64>(result);
+	nodeStorageBenchmarks<256>(result);
+	nodeStorageBenchmarks<1024>(result);
+	pmrBenchmarks<flat_hash_map<std::string, std::string>, void>("flat_hash_map<std::string, std::string>, default allocator", result);
+	pmrBenchmarks<pmr_flat_hash_map<std::pmr::string, std::pmr::string>, std::pmr::monotonic_buffer_resource>(
+		"pmr_flat_hash_map<std::pmr::string, std::pmr::string>, monotonic_buffer_resource", result);
+	pmrBenchmarks<pmr_flat_hash_map<std::pmr::string, std::pmr::string>, std::pmr::unsynchronized_pool_resource>(
+		"pmr_flat_hash_map<std::pmr::string, std::pmr::string>, unsynchronized_pool_resource", result);
+	pmrBenchmarks<DiscordCoreAPI::UnorderedMap<std::string, std::string>, void>("DiscordCoreAPI::UnorderedMap<std::string, std::string>, default allocator", result);
+	pmrBenchmarks<DiscordCoreAPI::PmrUnorderedMap<std::pmr::string, std::pmr::string>, std::pmr::monotonic_buffer_resource>(
+		"DiscordCoreAPI::PmrUnorderedMap<std::pmr::string, std::pmr::string>, monotonic_buffer_resource", result);
+	pmrBenchmarks<DiscordCoreAPI::PmrUnorderedMap<std::pmr::string, std::pmr::string>, std::pmr::unsynchronized_pool_resource>(
+		"DiscordCoreAPI::PmrUnorderedMap<std::pmr::string, std::pmr::string>, unsynchronized_pool_resource", result);
+
 	return 0;
 
 }